@@ -0,0 +1,46 @@
+// Бенчмарк масштабирования пакетного поиска findPaths(queries, pool) на
+// 1/2/4/8/16 потоках WorkStealingPool. Потоков больше, чем ядер, смысла
+// не имеет: число ядер печатается в заголовке, ускорение выше него не ждите.
+//
+//   g++ -std=c++23 -O2 -pthread bench_batch.cpp -o bench_batch
+//   ./bench_batch [size [queries]]     (по умолчанию 512 256)
+#include "bench_common.h"
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 512;
+    int queryCount = argc > 2 ? std::atoi(argv[2]) : 256;
+
+    Maze maze = bench::randomMaze(n, 4, 3);
+    // Различные старты: каждый запрос - отдельная задача пула
+    auto queries = bench::randomQueries(maze, n, queryCount, 3);
+
+    std::vector<std::vector<std::pair<int, int>>> serial;
+    bench::quietly([&] { serial = maze.findPaths(queries); });
+
+    std::cout << "Size " << n << ", " << queries.size() << " queries, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(12) << "ms"
+              << std::setw(14) << "queries/s" << "speedup" << std::endl;
+
+    double base = 0;
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u}) {
+        WorkStealingPool pool(threads);
+        std::vector<std::vector<std::pair<int, int>>> paths;
+        double ms;
+        bench::quietly([&] {
+            // Прогрев: thread_local буферы рабочих потоков
+            maze.findPaths(queries, pool);
+            ms = bench::millis([&] { paths = maze.findPaths(queries, pool); });
+        });
+
+        if (paths != serial) {
+            std::cout << "Parallel paths differ from serial at " << threads << " threads" << std::endl;
+            return 1;
+        }
+        if (threads == 1) base = ms;
+        std::cout << std::setw(10) << threads << std::setw(12) << std::fixed << std::setprecision(1) << ms
+                  << std::setw(14) << std::setprecision(0) << queries.size() / (ms / 1000.0)
+                  << std::setprecision(2) << base / ms << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Бенчмарк findPathBFS: память и пропускная способность на квадратных сетках
+// 1k-8k. Для сравнения воспроизведён прежний BFS, который держал в очереди
+// копию пути для каждой клетки; он квадратичен по памяти, поэтому запускается
+// только до legacy-max (по умолчанию 1024).
+//
+//   g++ -std=c++23 -O2 -pthread bench_bfs.cpp -o bench_bfs
+//   ./bench_bfs [legacy-max [size ...]]     (по умолчанию 1024  1024 2048 4096 8192)
+//
+// Пик памяти берётся из VmHWM, который сбрасывается перед каждым замером
+// записью в /proc/self/clear_refs (Linux).
+#include "bench_common.h"
+
+namespace {
+
+// Прежний findPathBFS: каждая запись очереди несёт свою копию пути
+std::vector<std::pair<int, int>> legacyBFS(const std::vector<std::vector<int>>& grid,
+                                           std::pair<int, int> start,
+                                           std::pair<int, int> end) {
+    int rows = grid.size();
+    int cols = grid[0].size();
+    std::vector<char> visited(static_cast<size_t>(rows) * cols, 0);
+    std::queue<std::pair<std::pair<int, int>, std::vector<std::pair<int, int>>>> q;
+
+    const int dx[4] = {-1, 0, 1, 0};
+    const int dy[4] = {0, 1, 0, -1};
+
+    q.push({start, {start}});
+    visited[start.first * cols + start.second] = 1;
+
+    while (!q.empty()) {
+        auto [current, path] = q.front();
+        q.pop();
+        if (current == end) return path;
+
+        for (int i = 0; i < 4; i++) {
+            int nx = current.first + dx[i];
+            int ny = current.second + dy[i];
+            if (nx < 0 || nx >= rows || ny < 0 || ny >= cols) continue;
+            if (grid[nx][ny] != 0 || visited[nx * cols + ny]) continue;
+            visited[nx * cols + ny] = 1;
+            std::vector<std::pair<int, int>> newPath = path;
+            newPath.push_back({nx, ny});
+            q.push({{nx, ny}, newPath});
+        }
+    }
+    return {};
+}
+
+long statusKb(const char* field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    size_t length = std::strlen(field);
+    while (std::getline(status, line)) {
+        if (line.compare(0, length, field) == 0) return std::atol(line.c_str() + length + 1);
+    }
+    return -1;
+}
+
+// Сбросить VmHWM до текущего VmRSS
+bool resetPeak() {
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5";
+    clear.flush();
+    return static_cast<bool>(clear);
+}
+
+struct Sample {
+    double ms;
+    long extraKb; // прирост пика памяти за замер, -1 если сбросить пик нельзя
+};
+
+template <typename F>
+Sample measure(F&& body) {
+    bool peakReset = resetPeak();
+    long before = statusKb("VmRSS:");
+    double ms = bench::millis(body);
+    long peak = statusKb("VmHWM:");
+    return {ms, peakReset ? peak - before : -1};
+}
+
+void printSample(const Sample& s, size_t expanded) {
+    std::cout << std::setw(12) << std::fixed << std::setprecision(1) << s.ms
+              << std::setw(12) << (s.extraKb < 0 ? std::string("n/a") : std::to_string(s.extraKb / 1024))
+              << std::setw(12) << std::setprecision(1) << expanded / (s.ms * 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int legacyMax = argc > 1 ? std::atoi(argv[1]) : 1024;
+    std::vector<int> sizes;
+    for (int i = 2; i < argc; i++) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = {1024, 2048, 4096, 8192};
+
+    std::cout << "Columns: time ms, extra peak memory MB, throughput M expanded cells/s" << std::endl;
+    std::cout << std::left << std::setw(8) << "size" << std::setw(12) << "expanded"
+              << std::setw(36) << "parent array" << "path copies" << std::endl;
+
+    for (int n : sizes) {
+        std::pair<int, int> start = {0, 0};
+        std::pair<int, int> end = {n - 1, n - 1};
+        bool legacy = n <= legacyMax;
+
+        std::vector<std::vector<int>> grid;
+        Maze maze = bench::randomMaze(n, 4, 11, legacy ? &grid : nullptr);
+
+        std::vector<std::pair<int, int>> path, oldPath;
+        Sample current, old{};
+        bench::quietly([&] {
+            // Первый замер включает выделение буферов потока - это и есть память поиска
+            current = measure([&] { path = maze.findPathBFS(start, end); });
+            if (legacy) old = measure([&] { oldPath = legacyBFS(grid, start, end); });
+        });
+        size_t expanded = maze.lastExpanded();
+
+        if (legacy && oldPath != path) {
+            std::cout << "Paths differ at " << n << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(8) << n << std::setw(12) << expanded;
+        printSample(current, expanded);
+        if (legacy) printSample(old, expanded);
+        else std::cout << "  skipped";
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Бенчмарк waveDistancesBitParallel против waveDistances: время полного поля
+// расстояний от угла, центра и случайной клетки. Поля сверяются поклеточно.
+// Сетки: пустое поле, случайные стены 25%, лабиринт Краскала с брайдингом.
+// Размер 1000 не кратен 64, так что проверяется и неполное последнее слово строки.
+//
+//   g++ -std=c++23 -O2 -pthread bench_bitwave.cpp -o bench_bitwave
+//   ./bench_bitwave [n ...]            (по умолчанию 1000 2048)
+#include "bench_common.h"
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = {1000, 2048};
+
+    std::cout << "Full distance field, best of 3 per source, ms" << std::endl;
+    std::cout << std::left << std::setw(8) << "n" << std::setw(16) << "maze" << std::setw(10) << "source"
+              << std::setw(12) << "queue" << std::setw(12) << "bit-par" << "ratio" << std::endl;
+
+    for (int n : sizes) {
+        std::vector<std::pair<std::string, Maze>> mazes;
+        mazes.emplace_back("open", Maze(n, n));
+        mazes.emplace_back("random 25%", bench::randomMaze(n, 4, 9));
+        mazes.emplace_back("kruskal+braid", bench::braidedMaze(n, 0.5, 9));
+
+        for (auto& [name, maze] : mazes) {
+            auto random = bench::randomQueries(maze, n, 1, 19)[0].first;
+            const std::pair<const char*, std::pair<int, int>> sources[] = {
+                {"corner", {0, 0}}, {"center", {n / 2, n / 2}}, {"random", random}};
+
+            for (auto [label, source] : sources) {
+                std::vector<int> expected, actual;
+                double queueMs = bench::millis([&] { expected = maze.waveDistances(source); }, 3);
+                double bitMs = bench::millis([&] { actual = maze.waveDistancesBitParallel(source); }, 3);
+                if (actual != expected) {
+                    size_t cell = std::mismatch(actual.begin(), actual.end(), expected.begin()).first - actual.begin();
+                    std::cout << "Distances differ on " << name << " " << n << " from " << label
+                              << " at cell (" << cell / n << ", " << cell % n << "): "
+                              << actual[cell] << " vs " << expected[cell] << std::endl;
+                    return 1;
+                }
+                std::cout << std::setw(8) << n << std::setw(16) << name << std::setw(10) << label
+                          << std::setw(12) << std::fixed << std::setprecision(1) << queueMs
+                          << std::setw(12) << bitMs << std::setprecision(2) << bitMs / queueMs << std::endl;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+// Бенчмарк braidMaze: время брайдинга сгенерированных лабиринтов и случайной
+// сетки с 45% стен (много тупиков, в том числе возникающих по ходу брайдинга).
+// Печатается число тупиков до и после: при braidFactor p каждый тупик
+// зашивается с вероятностью p, при p = 1 тупиков, которые можно зашить, не остаётся.
+//
+//   g++ -std=c++23 -O2 -pthread bench_braid.cpp -o bench_braid
+//   ./bench_braid [size]               (по умолчанию 10000)
+#include "bench_common.h"
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int cells = (n + 1) / 2;
+
+    std::vector<std::pair<std::string, Maze>> mazes;
+    bench::quietly([&] {
+        const std::pair<const char*, void (MazeGenerator::*)(Maze&, int, int)> generators[] = {
+            {"backtracker", &MazeGenerator::recursiveBacktracker},
+            {"kruskal", &MazeGenerator::kruskal},
+            {"eller", &MazeGenerator::eller},
+        };
+        for (auto [name, generate] : generators) {
+            Maze maze;
+            MazeGenerator generator(13);
+            (generator.*generate)(maze, cells, cells);
+            mazes.emplace_back(name, std::move(maze));
+        }
+    });
+    Maze dense(n, n);
+    std::mt19937_64 rng(13);
+    for (int x = 0; x < n; x++) {
+        for (int y = 0; y < n; y++) {
+            if (rng() % 100 < 45) dense.setCell(x, y, 1);
+        }
+    }
+    mazes.emplace_back("random 45%", std::move(dense));
+
+    std::cout << "Size " << n << std::endl;
+    std::cout << std::left << std::setw(14) << "maze" << std::setw(8) << "factor"
+              << std::setw(14) << "dead ends" << std::setw(14) << "after" << "ms" << std::endl;
+    for (auto& [name, maze] : mazes) {
+        size_t before = maze.computeStats().deadEnds;
+        for (double factor : {0.5, 1.0}) {
+            Maze braided(maze);
+            double ms = bench::millis([&] { braided.braidMaze(factor, 13, false); });
+            std::cout << std::setw(14) << name << std::setw(8) << factor << std::setw(14) << before
+                      << std::setw(14) << braided.computeStats().deadEnds
+                      << std::fixed << std::setprecision(0) << ms << std::defaultfloat << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Бенчмарк дерева поиска из main.cpp: узлы из общего пула под мьютексом против
+// прежнего new/delete на каждый узел (копия исходного Node). Раунд - вставка
+// n случайных ключей, n поисков и clear; порядок обхода сверяется.
+//
+//   g++ -std=c++23 -O2 -pthread bench_bst.cpp -o bench_bst
+//   ./bench_bst [n] [rounds]        (по умолчанию 100000 и 20)
+#define NO_DEMO_MAIN
+#define BENCH_WITHOUT_MAZE
+#include "main.cpp"
+#include "bench_common.h"
+
+#include <iomanip>
+#include <random>
+#include <string>
+
+namespace {
+
+// Node до перехода на пул: те же insert/find/clear, узлы через new/delete
+struct LegacyNode {
+    int x;
+    LegacyNode* left;
+    LegacyNode* right;
+};
+
+LegacyNode* legacyInsert(LegacyNode* n, int x) {
+    LegacyNode* new_n = new LegacyNode{x, nullptr, nullptr};
+    if (n == nullptr) {
+        return new_n;
+    }
+    LegacyNode* curr = n;
+    LegacyNode* parent = nullptr;
+    while (curr != nullptr) {
+        parent = curr;
+        curr = curr->x > x ? curr->left : curr->right;
+    }
+    (x < parent->x ? parent->left : parent->right) = new_n;
+    return n;
+}
+
+LegacyNode* legacyFind(LegacyNode* n, int x) {
+    while (n != nullptr && n->x != x) {
+        n = x < n->x ? n->left : n->right;
+    }
+    return n;
+}
+
+void legacyClear(LegacyNode*& n) {
+    if (n == nullptr) {
+        return;
+    }
+    std::stack<LegacyNode*> s;
+    s.push(n);
+    while (!s.empty()) {
+        LegacyNode* curr = s.top();
+        s.pop();
+        if (curr->left != nullptr) s.push(curr->left);
+        if (curr->right != nullptr) s.push(curr->right);
+        delete curr;
+    }
+    n = nullptr;
+}
+
+std::vector<int> legacySort(LegacyNode* n) {
+    std::vector<int> result;
+    std::stack<LegacyNode*> s;
+    while (n != nullptr || !s.empty()) {
+        while (n != nullptr) {
+            s.push(n);
+            n = n->left;
+        }
+        n = s.top();
+        s.pop();
+        result.push_back(n->x);
+        n = n->right;
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::mt19937_64 rng(22);
+    std::vector<std::vector<int>> keys(rounds, std::vector<int>(n));
+    for (auto& round : keys) {
+        for (int& key : round) key = static_cast<int>(rng() % (4 * static_cast<uint64_t>(n)));
+    }
+
+    // Проверка: оба дерева дают один и тот же отсортированный обход
+    Node node;
+    Node* pooled = nullptr;
+    LegacyNode* legacy = nullptr;
+    for (int key : keys[0]) {
+        pooled = node.insert(pooled, key);
+        legacy = legacyInsert(legacy, key);
+    }
+    bool same = node.sort(pooled) == legacySort(legacy);
+    node.clear(pooled);
+    legacyClear(legacy);
+    if (!same) {
+        std::cout << "Pooled and legacy trees differ" << std::endl;
+        return 1;
+    }
+
+    size_t found = 0;
+    double legacyMs = bench::millis([&] {
+        for (const auto& round : keys) {
+            LegacyNode* root = nullptr;
+            for (int key : round) root = legacyInsert(root, key);
+            for (int key : round) found += legacyFind(root, key ^ 1) != nullptr;
+            legacyClear(root);
+        }
+    }, 3);
+    double pooledMs = bench::millis([&] {
+        for (const auto& round : keys) {
+            Node* root = nullptr;
+            for (int key : round) root = node.insert(root, key);
+            for (int key : round) found += node.find(root, key ^ 1) != nullptr;
+            node.clear(root);
+        }
+    }, 3);
+
+    std::cout << "BST from main.cpp, " << n << " random keys x " << rounds
+              << " rounds (insert, find, clear), best of 3" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << std::left << std::setw(22) << "new/delete" << legacyMs << " ms" << std::endl
+              << std::setw(22) << "pool + mutex" << pooledMs << " ms" << std::endl
+              << std::setprecision(2) << "speedup " << legacyMs / pooledMs << "x"
+              << " (found " << found << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Общие части бенчмарков: project.cpp без демо, таймер, глушилка вывода
+// поисков и случайные сетки. Каждый бенчмарк подключает этот файл первым.
+// Бенчмарки не для Maze (main.cpp со своим SlabPool) определяют
+// BENCH_WITHOUT_MAZE и получают только таймер и глушилку.
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#ifndef BENCH_WITHOUT_MAZE
+#define NO_DEMO_MAIN
+#include "project.cpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace bench {
+
+// Лучшее время из repeats запусков body, мс
+template <typename F>
+double millis(F&& body, int repeats = 1) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repeats; i++) {
+        auto begin = std::chrono::steady_clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double, std::milli>(
+                                  std::chrono::steady_clock::now() - begin).count());
+    }
+    return best;
+}
+
+// Поиски печатают результат каждого запроса: пока объект жив, cout пишет в буфер
+class QuietOutput {
+    std::ostringstream sink;
+    std::streambuf* saved;
+
+public:
+    QuietOutput() : saved(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietOutput() { std::cout.rdbuf(saved); }
+    QuietOutput(const QuietOutput&) = delete;
+    QuietOutput& operator=(const QuietOutput&) = delete;
+};
+
+template <typename F>
+void quietly(F&& body) {
+    QuietOutput quiet;
+    body();
+}
+
+#ifndef BENCH_WITHOUT_MAZE
+using Query = std::pair<std::pair<int, int>, std::pair<int, int>>;
+
+// Сетка n x n, стена с вероятностью 1/wallOneIn; углы 2x2 у (0,0) и (n-1,n-1)
+// свободны. Если углы всё же оказались в разных компонентах, seed растёт и
+// сетка строится заново. grid, если передан, получает тот же узор (1 - стена).
+inline Maze randomMaze(int n, int wallOneIn, uint64_t seed,
+                       std::vector<std::vector<int>>* grid = nullptr) {
+    for (;; seed++) {
+        std::mt19937_64 rng(seed);
+        Maze maze(n, n);
+        if (grid) grid->assign(n, std::vector<int>(n, 0));
+        for (int x = 0; x < n; x++) {
+            for (int y = 0; y < n; y++) {
+                bool corner = (x < 2 && y < 2) || (x >= n - 2 && y >= n - 2);
+                if (!corner && rng() % wallOneIn == 0) {
+                    maze.setCell(x, y, 1);
+                    if (grid) (*grid)[x][y] = 1;
+                }
+            }
+        }
+        if (maze.sameComponent({0, 0}, {n - 1, n - 1})) return maze;
+    }
+}
+
+// Лабиринт Краскала (2k-1 x 2k-1 для k = (n+1)/2) с брайдингом
+inline Maze braidedMaze(int n, double braidFactor, uint64_t seed) {
+    Maze maze;
+    quietly([&] {
+        MazeGenerator generator(seed);
+        generator.kruskal(maze, (n + 1) / 2, (n + 1) / 2);
+        maze.braidMaze(braidFactor, seed, false);
+    });
+    return maze;
+}
+
+// count случайных пар проходов сетки n x n из одной компоненты
+inline std::vector<Query> randomQueries(const Maze& maze, int n, int count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Query> queries;
+    while (static_cast<int>(queries.size()) < count) {
+        std::pair<int, int> a = {static_cast<int>(rng() % n), static_cast<int>(rng() % n)};
+        std::pair<int, int> b = {static_cast<int>(rng() % n), static_cast<int>(rng() % n)};
+        if (maze.sameComponent(a, b)) queries.push_back({a, b});
+    }
+    return queries;
+}
+
+#endif
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,97 @@
+// Бенчмарк findPathDijkstra (корзины Дайала) против Дейкстры на
+// std::priority_queue на той же сетке стоимостей. Сетка - случайные стоимости
+// 1..max и 20% стен; запрос - из угла в угол. Стоимости путей сверяются.
+// Версия с кучей работает на плоском массиве с рамкой, как и Maze, чтобы
+// разница была только в очереди.
+//
+//   g++ -std=c++23 -O2 -pthread bench_dijkstra.cpp -o bench_dijkstra
+//   ./bench_dijkstra [size [repeats]]  (по умолчанию 2048 3)
+#include "bench_common.h"
+
+namespace {
+
+// Дейкстра с кучей и ленивым удалением устаревших записей; 0 в cost - стена
+int64_t heapDijkstra(const std::vector<int>& cost, int width, int startKey, int endKey,
+                     std::vector<int64_t>& dist, std::vector<int>& parent) {
+    const int offsets[4] = {-width, 1, width, -1};
+    dist.assign(cost.size(), std::numeric_limits<int64_t>::max());
+    parent.assign(cost.size(), -1);
+    using Entry = std::pair<int64_t, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    dist[startKey] = 0;
+    open.push({0, startKey});
+
+    while (!open.empty()) {
+        auto [d, key] = open.top();
+        open.pop();
+        if (d != dist[key]) continue;
+        if (key == endKey) return d;
+        for (int k = 0; k < 4; k++) {
+            int nkey = key + offsets[k];
+            if (cost[nkey] == 0) continue;
+            int64_t nd = d + cost[nkey];
+            if (nd < dist[nkey]) {
+                dist[nkey] = nd;
+                parent[nkey] = key;
+                open.push({nd, nkey});
+            }
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 2048;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::cout << "Size " << n << ", 20% walls, corner to corner, best of " << repeats << std::endl;
+    std::cout << std::left << std::setw(10) << "costs" << std::setw(12) << "Dial ms"
+              << std::setw(12) << "heap ms" << std::setw(10) << "speedup" << "path cost" << std::endl;
+
+    for (int top : {1, 4, 9, 32, 255}) {
+        // Стены из общей случайной сетки, проходам - стоимости 1..top
+        std::vector<std::vector<int>> grid;
+        bench::randomMaze(n, 5, 18 + top, &grid);
+        std::mt19937_64 rng(18 + top);
+        for (auto& row : grid) {
+            for (int& cell : row) cell = cell ? 0 : 1 + rng() % top;
+        }
+        Maze maze;
+        maze.setCostGrid(grid);
+
+        // Та же сетка для кучи: плоский массив с рамкой из стен
+        int width = n + 2;
+        std::vector<int> cost(static_cast<size_t>(width) * width, 0);
+        for (int x = 0; x < n; x++) {
+            for (int y = 0; y < n; y++) cost[(x + 1) * width + y + 1] = grid[x][y];
+        }
+        std::vector<int64_t> dist;
+        std::vector<int> parent;
+
+        std::pair<int, int> start = {0, 0}, end = {n - 1, n - 1};
+        WeightedPath dial;
+        double dialMs;
+        bench::quietly([&] {
+            dialMs = bench::millis([&] { dial = maze.findPathDijkstra(start, end); }, repeats);
+        });
+
+        int64_t heapCost = -1;
+        double heapMs = bench::millis([&] {
+            heapCost = heapDijkstra(cost, width, width + 1, n * width + n, dist, parent);
+        }, repeats);
+
+        if (dial.cost != heapCost) {
+            std::cout << "Path costs differ at 1.." << top << ": Dial " << dial.cost
+                      << ", heap " << heapCost << std::endl;
+            return 1;
+        }
+        std::ostringstream speedup;
+        speedup << std::fixed << std::setprecision(2) << heapMs / dialMs << "x";
+        std::cout << std::setw(10) << ("1.." + std::to_string(top)) << std::setw(12) << std::fixed
+                  << std::setprecision(1) << dialMs << std::setw(12) << heapMs << std::setw(10)
+                  << speedup.str() << dial.cost << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// Бенчмарк HierarchicalIndex (HPA*) против findPathWave: время предобработки,
+// объём индекса и время на запрос для кластеров 16 и 32. Каждый путь индекса
+// проверяется (из start в end, соседние клетки, только проходы), а его длина
+// сравнивается с кратчайшей волной. HPA* проходит через середины входов и не
+// сглаживает путь: у каждого конца возможен крюк до входа и обратно (до
+// clusterSize шагов), а в остальном путь длиннее кратчайшего не больше чем
+// в MAX_STRETCH раз.
+//
+//   g++ -std=c++23 -O2 -pthread bench_hpa.cpp -o bench_hpa
+//   ./bench_hpa [size [queries]]       (по умолчанию 1024 200)
+#include "bench_common.h"
+
+namespace {
+
+constexpr double MAX_STRETCH = 1.25;
+
+bool validPath(const Maze& maze, const std::vector<std::pair<int, int>>& path,
+               std::pair<int, int> start, std::pair<int, int> end) {
+    if (path.empty() || path.front() != start || path.back() != end) return false;
+    for (size_t i = 0; i < path.size(); i++) {
+        if (maze.cellCost(path[i].first, path[i].second) == 0) return false;
+        if (i > 0 && std::abs(path[i].first - path[i - 1].first) +
+                     std::abs(path[i].second - path[i - 1].second) != 1) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int queryCount = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::vector<std::pair<std::string, Maze>> mazes;
+    mazes.emplace_back("open", Maze(n, n));
+    mazes.emplace_back("random 25%", bench::randomMaze(n, 4, 12));
+    mazes.emplace_back("kruskal+braid", bench::braidedMaze(n, 0.5, 12));
+
+    std::cout << "Size " << n << ", " << queryCount << " random queries per maze, times per query" << std::endl;
+    std::cout << std::left << std::setw(16) << "maze" << std::setw(9) << "cluster"
+              << std::setw(10) << "build ms" << std::setw(11) << "index KB"
+              << std::setw(10) << "hpa ms" << std::setw(10) << "wave ms" << std::setw(10) << "speedup"
+              << std::setw(14) << "mean stretch" << "max stretch" << std::endl;
+
+    for (auto& [name, maze] : mazes) {
+        auto queries = bench::randomQueries(maze, n, queryCount, 112);
+
+        // Кратчайшие длины и время волны не зависят от размера кластера
+        std::vector<size_t> shortest;
+        double waveMs = 0;
+        bench::quietly([&] {
+            maze.findPathWave(queries[0].first, queries[0].second);
+            for (auto [start, end] : queries) {
+                waveMs += bench::millis([&] { shortest.push_back(maze.findPathWave(start, end).size()); });
+            }
+        });
+        waveMs /= queries.size();
+
+        for (int clusterSize : {16, 32}) {
+            double buildMs = 0;
+            std::unique_ptr<HierarchicalIndex> index;
+            buildMs = bench::millis([&] { index = std::make_unique<HierarchicalIndex>(maze, clusterSize); });
+
+            double hpaMs = 0, stretchSum = 0, stretchMax = 0;
+            bool ok = true;
+            bench::quietly([&] {
+                for (size_t i = 0; i < queries.size() && ok; i++) {
+                    auto [start, end] = queries[i];
+                    std::vector<std::pair<int, int>> path;
+                    hpaMs += bench::millis([&] { path = index->findPath(start, end); });
+                    ok = validPath(maze, path, start, end) && path.size() >= shortest[i] &&
+                         path.size() - 1 <= MAX_STRETCH * (shortest[i] - 1) + 2 * clusterSize;
+                    double stretch = ok ? static_cast<double>(path.size() - 1) /
+                                              std::max<size_t>(shortest[i] - 1, 1) : 0;
+                    stretchSum += stretch;
+                    stretchMax = std::max(stretchMax, stretch);
+                }
+            });
+            if (!ok) {
+                std::cout << "Invalid or too long hierarchical path on " << name
+                          << " (cluster " << clusterSize << ")" << std::endl;
+                return 1;
+            }
+            hpaMs /= queries.size();
+
+            std::cout << std::setw(16) << name << std::setw(9) << clusterSize << std::fixed
+                      << std::setw(10) << std::setprecision(1) << buildMs
+                      << std::setw(11) << index->memoryBytes() / 1024
+                      << std::setw(10) << std::setprecision(3) << hpaMs
+                      << std::setw(10) << waveMs
+                      << std::setw(10) << std::setprecision(1) << waveMs / hpaMs
+                      << std::setw(14) << std::setprecision(3) << stretchSum / queries.size()
+                      << stretchMax << std::endl;
+        }
+    }
+    return 0;
+}
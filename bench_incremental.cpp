@@ -0,0 +1,89 @@
+// Бенчмарк IncrementalPlanner: задержка починки пути после 1..10000 правок
+// против полного пересчёта findPathWave (и нового планировщика для справки).
+// Время починки включает сами правки через planner.setCell. Ускорение
+// считается относительно волны; в конце печатается число правок, с которого
+// починка перестаёт окупаться. Правки - переключение случайных клеток
+// (стена <-> проход), старт и цель не трогаются. Длина каждого пути
+// сверяется с findPathWave.
+//
+//   g++ -std=c++23 -O2 -pthread bench_incremental.cpp -o bench_incremental
+//   ./bench_incremental [size [rounds]]    (по умолчанию 1024 5)
+#include "bench_common.h"
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::pair<int, int> start = {0, 0};
+    std::pair<int, int> goal = {n - 1, n - 1};
+    Maze maze = bench::randomMaze(n, 5, 21);
+    std::mt19937_64 rng(21);
+
+    IncrementalPlanner planner(maze, start, goal);
+    double initial;
+    bench::quietly([&] { initial = bench::millis([&] { planner.findPath(); }); });
+
+    std::cout << "Size " << n << ", 20% walls, " << rounds << " rounds per row, averages per repair" << std::endl;
+    std::cout << "Initial planner search: " << std::fixed << std::setprecision(1) << initial << " ms" << std::endl;
+    std::cout << std::left << std::setw(8) << "edits" << std::setw(14) << "repair ms"
+              << std::setw(16) << "repair expanded" << std::setw(16) << "scratch ms"
+              << std::setw(12) << "wave ms" << "speedup vs wave" << std::endl;
+
+    int lastWin = 0, breakEven = 0;
+    for (int edits : {1, 3, 10, 30, 100, 300, 1000, 3000, 10000}) {
+        double repairMs = 0, fullMs = 0, waveMs = 0;
+        size_t repairExpanded = 0;
+        for (int r = 0; r < rounds; r++) {
+            std::vector<std::pair<int, int>> cells(edits);
+            for (auto& [x, y] : cells) {
+                do {
+                    x = rng() % n;
+                    y = rng() % n;
+                } while ((x < 2 && y < 2) || (x >= n - 2 && y >= n - 2));
+            }
+
+            std::vector<std::pair<int, int>> repaired, fresh, wave;
+            bench::quietly([&] {
+                repairMs += bench::millis([&] {
+                    for (auto [x, y] : cells) planner.setCell(x, y, maze.cellCost(x, y) == 0 ? 0 : 1);
+                    repaired = planner.findPath();
+                });
+                repairExpanded += planner.lastExpanded();
+                fullMs += bench::millis([&] {
+                    IncrementalPlanner scratch(maze, start, goal);
+                    fresh = scratch.findPath();
+                });
+                waveMs += bench::millis([&] { wave = maze.findPathWave(start, goal); });
+            });
+
+            if (repaired.size() != wave.size() || fresh.size() != wave.size()) {
+                std::cout << "Path length mismatch after " << edits << " edits: repaired "
+                          << repaired.size() << ", scratch " << fresh.size()
+                          << ", wave " << wave.size() << std::endl;
+                return 1;
+            }
+        }
+        std::cout << std::setw(8) << edits << std::setw(14) << std::setprecision(2) << repairMs / rounds
+                  << std::setw(16) << repairExpanded / rounds << std::setw(16) << fullMs / rounds
+                  << std::setw(12) << waveMs / rounds
+                  << waveMs / repairMs << "x" << std::endl;
+        if (repairMs < waveMs && !breakEven) lastWin = edits;
+        if (repairMs >= waveMs && !breakEven) breakEven = edits;
+    }
+    if (breakEven) {
+        std::cout << "Repair stops paying off between " << lastWin << " and " << breakEven
+                  << " edits per query" << std::endl;
+    } else {
+        std::cout << "Repair beats the wave up to 10000 edits per query" << std::endl;
+    }
+
+    // Изменение в обход планировщика (та же размерность) должно сбросить его
+    maze.setGrid(std::vector<std::vector<int>>(n, std::vector<int>(n, 0)));
+    std::vector<std::pair<int, int>> afterReload;
+    bench::quietly([&] { afterReload = planner.findPath(); });
+    if (static_cast<int>(afterReload.size()) != 2 * n - 1) {
+        std::cout << "Planner kept a stale path after setGrid" << std::endl;
+        return 1;
+    }
+    return 0;
+}
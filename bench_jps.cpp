@@ -0,0 +1,75 @@
+// Бенчмарк findPathJPS против findPathWave и findPathAStar: число раскрытых
+// клеток и время на запрос. Сетки - пустое поле, случайные стены (25%) и
+// идеальный лабиринт Краскала с брайдингом; запросы - случайные пары проходов.
+//
+//   g++ -std=c++23 -O2 -pthread bench_jps.cpp -o bench_jps
+//   ./bench_jps [size [queries]]       (по умолчанию 1024 20)
+#include "bench_common.h"
+
+namespace {
+
+using Search = std::vector<std::pair<int, int>> (Maze::*)(std::pair<int, int>, std::pair<int, int>) const;
+
+struct Result {
+    double ms = 0;
+    double expanded = 0;
+    size_t length = 0;
+};
+
+Result run(const Maze& maze, Search search, const std::vector<bench::Query>& queries) {
+    Result r;
+    for (auto [start, end] : queries) {
+        std::vector<std::pair<int, int>> path;
+        r.ms += bench::millis([&] { path = (maze.*search)(start, end); });
+        r.expanded += maze.lastExpanded();
+        r.length += path.size();
+    }
+    r.ms /= queries.size();
+    r.expanded /= queries.size();
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int queryCount = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<std::pair<std::string, Maze>> mazes;
+    mazes.emplace_back("open", Maze(n, n));
+    mazes.emplace_back("random 25%", bench::randomMaze(n, 4, 5));
+    mazes.emplace_back("kruskal+braid", bench::braidedMaze(n, 0.5, 5));
+
+    const std::pair<const char*, Search> searches[] = {
+        {"wave", &Maze::findPathWave},
+        {"A*", &Maze::findPathAStar},
+        {"JPS", &Maze::findPathJPS},
+    };
+
+    std::cout << "Size " << n << ", " << queryCount << " random queries per maze, averages per query" << std::endl;
+    std::cout << std::left << std::setw(16) << "maze" << std::setw(8) << "search"
+              << std::setw(14) << "expanded" << std::setw(12) << "ms" << "path" << std::endl;
+
+    for (auto& [name, maze] : mazes) {
+        auto queries = bench::randomQueries(maze, n, queryCount, 17);
+
+        std::vector<Result> results;
+        bench::quietly([&] {
+            // Прогрев: буферы потока и индекс компонент
+            maze.findPathWave(queries[0].first, queries[0].second);
+            for (auto& search : searches) results.push_back(run(maze, search.second, queries));
+        });
+
+        for (size_t i = 0; i < results.size(); i++) {
+            if (results[i].length != results[0].length) {
+                std::cout << searches[i].first << " path lengths differ from wave on " << name << std::endl;
+                return 1;
+            }
+            std::cout << std::setw(16) << name << std::setw(8) << searches[i].first
+                      << std::setw(14) << std::fixed << std::setprecision(0) << results[i].expanded
+                      << std::setw(12) << std::setprecision(2) << results[i].ms
+                      << results[i].length / queries.size() << std::endl;
+        }
+    }
+    return 0;
+}
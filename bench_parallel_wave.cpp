@@ -0,0 +1,80 @@
+// Бенчмарк параллельной волны waveDistances(source, pool):
+//  1) подбор порога WaveSwitch::topDown - когда переходить к bottom-up;
+//  2) масштабирование на 1/2/4/8/16 потоках относительно последовательной волны.
+// Сетки: пустое поле, случайные стены (25%) и лабиринт Краскала с брайдингом.
+// Каждый результат сверяется с последовательным waveDistances.
+//
+//   g++ -std=c++23 -O2 -pthread bench_parallel_wave.cpp -o bench_parallel_wave
+//   ./bench_parallel_wave [size]       (по умолчанию 1024)
+#include "bench_common.h"
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 1024;
+
+    std::vector<std::pair<std::string, Maze>> mazes;
+    mazes.emplace_back("open", Maze(n, n));
+    mazes.emplace_back("random 25%", bench::randomMaze(n, 4, 9));
+    mazes.emplace_back("kruskal+braid", bench::braidedMaze(n, 0.5, 9));
+
+    const std::pair<int, int> source = {0, 0};
+    std::vector<std::vector<int>> reference;
+    std::vector<double> serialMs;
+    for (auto& [name, maze] : mazes) {
+        std::vector<int> dist;
+        serialMs.push_back(bench::millis([&] { dist = maze.waveDistances(source); }, 3));
+        reference.push_back(std::move(dist));
+    }
+
+    std::cout << "Size " << n << ", source (0,0), best of 3, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    // 1) Порог перехода к bottom-up на всех ядрах; 0 - только top-down
+    WorkStealingPool pool;
+    std::cout << "\ntopDown factor sweep (" << pool.size() << " threads), ms" << std::endl;
+    std::cout << std::left << std::setw(10) << "factor";
+    for (auto& maze : mazes) std::cout << std::setw(16) << maze.first;
+    std::cout << std::endl;
+    std::cout << std::setw(10) << "serial";
+    for (double ms : serialMs) std::cout << std::setw(16) << std::fixed << std::setprecision(1) << ms;
+    std::cout << std::endl;
+
+    for (size_t factor : {0, 4, 16, 64, 256, 1024}) {
+        WaveSwitch tuning;
+        tuning.topDown = factor;
+        std::cout << std::setw(10) << factor;
+        for (size_t m = 0; m < mazes.size(); m++) {
+            std::vector<int> dist;
+            double ms = bench::millis([&] { dist = mazes[m].second.waveDistances(source, pool, tuning); }, 3);
+            if (dist != reference[m]) {
+                std::cout << "\nDistances differ on " << mazes[m].first << std::endl;
+                return 1;
+            }
+            std::cout << std::setw(16) << ms;
+        }
+        std::cout << std::endl;
+    }
+
+    // 2) Масштабирование с порогами по умолчанию
+    std::cout << "\nthread scaling (default WaveSwitch), ms and speedup over serial" << std::endl;
+    std::cout << std::setw(10) << "threads";
+    for (auto& maze : mazes) std::cout << std::setw(22) << maze.first;
+    std::cout << std::endl;
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u}) {
+        WorkStealingPool scaled(threads);
+        std::cout << std::setw(10) << threads;
+        for (size_t m = 0; m < mazes.size(); m++) {
+            std::vector<int> dist;
+            double ms = bench::millis([&] { dist = mazes[m].second.waveDistances(source, scaled); }, 3);
+            if (dist != reference[m]) {
+                std::cout << "\nDistances differ on " << mazes[m].first << std::endl;
+                return 1;
+            }
+            std::ostringstream cell;
+            cell << std::fixed << std::setprecision(1) << ms << " ("
+                 << std::setprecision(2) << serialMs[m] / ms << "x)";
+            std::cout << std::setw(22) << cell.str();
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+// Бенчмарк computeStats: последовательный проход и плитки на пуле против
+// построения индекса компонент (componentCount), которым раньше считалось поле
+// components. Число компонент и степени сверяются между всеми вариантами.
+// Сетки: пустое поле, случайные стены 25% и 45%, лабиринт Краскала.
+//
+//   g++ -std=c++23 -O2 -pthread bench_stats.cpp -o bench_stats
+//   ./bench_stats [size]               (по умолчанию 4000)
+#include "bench_common.h"
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? std::atoi(argv[1]) : 4000;
+
+    std::vector<std::pair<std::string, Maze>> mazes;
+    mazes.emplace_back("open", Maze(n, n));
+    mazes.emplace_back("random 25%", bench::randomMaze(n, 4, 14));
+    // Почти на пороге протекания: много мелких компонент через границы плиток
+    Maze dense(n, n);
+    std::mt19937_64 rng(14);
+    for (int x = 0; x < n; x++) {
+        for (int y = 0; y < n; y++) {
+            if (rng() % 100 < 45) dense.setCell(x, y, 1);
+        }
+    }
+    mazes.emplace_back("random 45%", std::move(dense));
+    mazes.emplace_back("kruskal", bench::braidedMaze(n, 0, 14));
+
+    WorkStealingPool pool;
+    std::cout << "Size " << n << ", " << pool.size() << " pool threads, best of 3" << std::endl;
+    std::cout << std::left << std::setw(14) << "maze" << std::setw(14) << "serial ms"
+              << std::setw(14) << "pool ms" << std::setw(16) << "index build ms" << "components" << std::endl;
+
+    for (auto& [name, maze] : mazes) {
+        MazeStats serial, tiled;
+        double serialMs = bench::millis([&] { serial = maze.computeStats(); }, 3);
+        double poolMs = bench::millis([&] { tiled = maze.computeStats(pool); }, 3);
+        size_t indexed = 0;
+        double indexMs = bench::millis([&] {
+            Maze copy(maze);
+            indexed = copy.componentCount();
+        });
+
+        if (serial.components != indexed || tiled.components != indexed ||
+            serial.degrees != tiled.degrees || serial.passable != tiled.passable) {
+            std::cout << "Stats differ on " << name << ": components serial " << serial.components
+                      << ", tiled " << tiled.components << ", index " << indexed << std::endl;
+            return 1;
+        }
+        std::cout << std::setw(14) << name << std::setw(14) << std::fixed << std::setprecision(1)
+                  << serialMs << std::setw(14) << poolMs << std::setw(16) << indexMs
+                  << indexed << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+// Бенчмарк Avl_Tree:
+//  1) узлы из SlabPool против прежних new/delete на каждый узел;
+//  2) итеративные вставка/удаление/поиск Avl_Tree против прежних рекурсивных;
+//  3) CompactAvlTree (16-байтные узлы в одном векторе) против Avl_Tree: память,
+//     поиск и вставка/удаление.
+// Прежнее рекурсивное AVL-дерево воспроизведено ниже с выбираемым источником
+// узлов, поэтому в 1) разница только в аллокаторе, а в 2) (оба на пуле) -
+// только в обходе.
+// Нагрузка: заполнение n случайными ключами, затем n пар вставка + удаление
+// случайных ключей (размер дерева держится около n) и очистка; поиск - n
+// запросов случайных ключей к дереву из n ключей.
+//
+//   g++ -std=c++23 -O2 -pthread bench_tree.cpp -o bench_tree
+//   ./bench_tree [n ...]               (по умолчанию 100000 1000000)
+#include "bench_common.h"
+
+namespace {
+
+struct LegacyNode {
+    int key;
+    LegacyNode* left;
+    LegacyNode* right;
+    int height;
+    size_t size;
+    LegacyNode(int k): key(k), left(nullptr), right(nullptr), height(1), size(1) {}
+};
+
+// Прежний путь: отдельный new/delete на каждый узел
+struct HeapNodes {
+    LegacyNode* create(int key) { return new LegacyNode(key); }
+    void destroy(LegacyNode* node) { delete node; }
+};
+
+struct PooledNodes {
+    SlabPool<LegacyNode> pool;
+    LegacyNode* create(int key) { return pool.create(key); }
+    void destroy(LegacyNode* node) { pool.destroy(node); }
+};
+
+// Рекурсивное AVL-дерево в том виде, как оно было до пула
+template <typename Nodes>
+class LegacyTree {
+    LegacyNode* root = nullptr;
+    Nodes nodes;
+
+    static int height(LegacyNode* node) { return node ? node->height : 0; }
+    static size_t size(LegacyNode* node) { return node ? node->size : 0; }
+
+    static void update(LegacyNode* node) {
+        node->height = 1 + std::max(height(node->left), height(node->right));
+        node->size = 1 + size(node->left) + size(node->right);
+    }
+
+    static int getBalance(LegacyNode* node) {
+        return height(node->left) - height(node->right);
+    }
+
+    static LegacyNode* rotateR(LegacyNode* y) {
+        LegacyNode* x = y->left;
+        y->left = x->right;
+        x->right = y;
+        update(y);
+        update(x);
+        return x;
+    }
+
+    static LegacyNode* rotateL(LegacyNode* x) {
+        LegacyNode* y = x->right;
+        x->right = y->left;
+        y->left = x;
+        update(x);
+        update(y);
+        return y;
+    }
+
+    static LegacyNode* balance(LegacyNode* node) {
+        update(node);
+        int bal = getBalance(node);
+        if (bal > 1) {
+            if (getBalance(node->left) < 0) node->left = rotateL(node->left);
+            return rotateR(node);
+        }
+        if (bal < -1) {
+            if (getBalance(node->right) > 0) node->right = rotateR(node->right);
+            return rotateL(node);
+        }
+        return node;
+    }
+
+    LegacyNode* insertNode(LegacyNode* node, int key, bool& inserted) {
+        if (!node) {
+            inserted = true;
+            return nodes.create(key);
+        }
+        if (key < node->key) {
+            node->left = insertNode(node->left, key, inserted);
+        } else if (key > node->key) {
+            node->right = insertNode(node->right, key, inserted);
+        } else {
+            return node;
+        }
+        return balance(node);
+    }
+
+    LegacyNode* deleteNode(LegacyNode* node, int key, bool& deleted) {
+        if (!node) return nullptr;
+        if (key < node->key) {
+            node->left = deleteNode(node->left, key, deleted);
+        } else if (key > node->key) {
+            node->right = deleteNode(node->right, key, deleted);
+        } else {
+            deleted = true;
+            if (!node->left || !node->right) {
+                LegacyNode* child = node->left ? node->left : node->right;
+                nodes.destroy(node);
+                return child;
+            }
+            LegacyNode* successor = node->right;
+            while (successor->left) successor = successor->left;
+            node->key = successor->key;
+            node->right = deleteNode(node->right, successor->key, deleted);
+        }
+        return balance(node);
+    }
+
+    bool findNode(LegacyNode* node, int key) const {
+        if (!node) return false;
+        if (key < node->key) return findNode(node->left, key);
+        if (key > node->key) return findNode(node->right, key);
+        return true;
+    }
+
+    void clear(LegacyNode* node) {
+        if (node) {
+            clear(node->left);
+            clear(node->right);
+            nodes.destroy(node);
+        }
+    }
+
+public:
+    ~LegacyTree() { clear(root); }
+
+    bool insert(int key) {
+        bool inserted = false;
+        root = insertNode(root, key, inserted);
+        return inserted;
+    }
+
+    bool remove(int key) {
+        bool deleted = false;
+        root = deleteNode(root, key, deleted);
+        return deleted;
+    }
+
+    bool contains(int key) const { return findNode(root, key); }
+
+    size_t size() const { return size(root); }
+};
+
+// Заполнение, n пар вставка + удаление, очистка при выходе из области;
+// возвращает итоговый размер дерева для сверки вариантов
+template <typename Tree>
+size_t churn(int n, double& ms) {
+    std::mt19937_64 rng(22);
+    size_t finalSize;
+    ms = bench::millis([&] {
+        Tree tree;
+        for (int i = 0; i < n; i++) tree.insert(rng() % (2 * n));
+        for (int i = 0; i < n; i++) {
+            tree.insert(rng() % (2 * n));
+            tree.remove(rng() % (2 * n));
+        }
+        finalSize = tree.size();
+    });
+    return finalSize;
+}
+
+// n поисков случайных ключей (примерно половина промахов);
+// возвращает число найденных для сверки вариантов
+template <typename Tree>
+size_t lookups(int n, double& ms) {
+    std::mt19937_64 rng(24);
+    Tree tree;
+    for (int i = 0; i < n; i++) tree.insert(rng() % (2 * n));
+    size_t found = 0;
+    ms = bench::millis([&] {
+        for (int i = 0; i < n; i++) found += tree.contains(rng() % (2 * n));
+    });
+    return found;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = {100000, 1000000};
+
+    // Прогоны рекурсивного дерева на пуле общие для обеих таблиц
+    std::vector<double> recursiveChurnMs;
+    std::vector<size_t> recursiveSizes;
+
+    std::cout << "1) Insert/erase churn: fill n keys, n insert+erase pairs, clear" << std::endl;
+    std::cout << std::left << std::setw(10) << "n" << std::setw(16) << "new/delete ms"
+              << std::setw(12) << "pool ms" << "speedup" << std::endl;
+    for (int n : sizes) {
+        double heapMs, poolMs;
+        size_t heapSize = churn<LegacyTree<HeapNodes>>(n, heapMs);
+        size_t poolSize = churn<LegacyTree<PooledNodes>>(n, poolMs);
+        if (heapSize != poolSize) {
+            std::cout << "Tree sizes differ at n = " << n << std::endl;
+            return 1;
+        }
+        recursiveChurnMs.push_back(poolMs);
+        recursiveSizes.push_back(poolSize);
+        std::cout << std::setw(10) << n << std::setw(16) << std::fixed << std::setprecision(1) << heapMs
+                  << std::setw(12) << poolMs << std::setprecision(2) << heapMs / poolMs << "x" << std::endl;
+    }
+
+    std::cout << "\n2) Recursive vs iterative Avl_Tree, both pooled, ms" << std::endl;
+    std::cout << std::setw(10) << "n" << std::setw(16) << "churn rec" << std::setw(16) << "churn iter"
+              << std::setw(16) << "lookup rec" << "lookup iter" << std::endl;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        int n = sizes[i];
+        double iterChurnMs, recLookupMs, iterLookupMs;
+        size_t iterSize = churn<Avl_Tree>(n, iterChurnMs);
+        size_t recFound = lookups<LegacyTree<PooledNodes>>(n, recLookupMs);
+        size_t iterFound = lookups<Avl_Tree>(n, iterLookupMs);
+        if (iterSize != recursiveSizes[i] || iterFound != recFound) {
+            std::cout << "Iterative and recursive trees disagree at n = " << n << std::endl;
+            return 1;
+        }
+        std::cout << std::setw(10) << n << std::setw(16) << std::setprecision(1) << recursiveChurnMs[i]
+                  << std::setw(16) << iterChurnMs << std::setw(16) << recLookupMs
+                  << iterLookupMs << std::endl;
+    }
+
+    std::cout << "\n3) Avl_Tree vs CompactAvlTree: memory after filling n keys, ms" << std::endl;
+    std::cout << std::setw(10) << "n" << std::setw(14) << "avl KB" << std::setw(14) << "compact KB"
+              << std::setw(14) << "lookup avl" << std::setw(16) << "lookup compact"
+              << std::setw(14) << "churn avl" << "churn compact" << std::endl;
+    for (int n : sizes) {
+        std::mt19937_64 rng(23);
+        Avl_Tree avl;
+        CompactAvlTree compact;
+        for (int i = 0; i < n; i++) {
+            int key = rng() % (2 * n);
+            avl.insert(key);
+            compact.insert(key);
+        }
+        double avlLookupMs, compactLookupMs, avlChurnMs, compactChurnMs;
+        size_t avlFound = lookups<Avl_Tree>(n, avlLookupMs);
+        size_t compactFound = lookups<CompactAvlTree>(n, compactLookupMs);
+        size_t avlSize = churn<Avl_Tree>(n, avlChurnMs);
+        size_t compactSize = churn<CompactAvlTree>(n, compactChurnMs);
+        if (avl.size() != compact.size() || avlFound != compactFound || avlSize != compactSize) {
+            std::cout << "Avl_Tree and CompactAvlTree disagree at n = " << n << std::endl;
+            return 1;
+        }
+        std::cout << std::setw(10) << n << std::setw(14) << avl.memoryBytes() / 1024
+                  << std::setw(14) << compact.memoryBytes() / 1024
+                  << std::setw(14) << std::setprecision(1) << avlLookupMs
+                  << std::setw(16) << compactLookupMs << std::setw(14) << avlChurnMs
+                  << compactChurnMs << std::endl;
+    }
+    return 0;
+}
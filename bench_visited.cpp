@@ -0,0 +1,100 @@
+// Бенчмарк: плоский массив посещённых клеток (метки эпох) против прежнего
+// Avl_Tree visitedCells в волновом поиске. Старый вариант воспроизведён ниже
+// на исходной сетке vector<vector<int>>, как он был до перехода на биты.
+//
+//   g++ -std=c++23 -O2 -pthread bench_visited.cpp -o bench_visited
+//   ./bench_visited [size ...]        (по умолчанию 512 1024 2048)
+#include "bench_common.h"
+
+namespace {
+
+// Прежний findPathWave: волна по vector<vector<int>>, каждая посещённая
+// клетка дополнительно вставляется в Avl_Tree
+std::vector<std::pair<int, int>> legacyWave(const std::vector<std::vector<int>>& grid,
+                                            Avl_Tree& visitedCells,
+                                            std::pair<int, int> start,
+                                            std::pair<int, int> end) {
+    int rows = grid.size();
+    int cols = grid[0].size();
+    auto isPassable = [&](int x, int y) {
+        return x >= 0 && x < rows && y >= 0 && y < cols && grid[x][y] == 0;
+    };
+
+    std::vector<std::vector<int>> wave(rows, std::vector<int>(cols, -1));
+    std::vector<std::vector<std::pair<int, int>>> parent(rows,
+        std::vector<std::pair<int, int>>(cols, {-1, -1}));
+    std::queue<std::pair<int, int>> q;
+
+    wave[start.first][start.second] = 0;
+    q.push(start);
+
+    const int dx[4] = {-1, 0, 1, 0};
+    const int dy[4] = {0, 1, 0, -1};
+    bool found = false;
+
+    while (!q.empty()) {
+        auto [x, y] = q.front();
+        q.pop();
+        if (x == end.first && y == end.second) {
+            found = true;
+            break;
+        }
+        for (int i = 0; i < 4; i++) {
+            int nx = x + dx[i];
+            int ny = y + dy[i];
+            if (isPassable(nx, ny) && wave[nx][ny] == -1) {
+                wave[nx][ny] = wave[x][y] + 1;
+                parent[nx][ny] = {x, y};
+                q.push({nx, ny});
+                visitedCells.insert(nx * cols + ny);
+            }
+        }
+    }
+    if (!found) return {};
+
+    std::vector<std::pair<int, int>> path;
+    for (auto current = end; current != start; current = parent[current.first][current.second]) {
+        path.push_back(current);
+    }
+    path.push_back(start);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = {512, 1024, 2048};
+
+    std::cout << std::left << std::setw(8) << "size" << std::setw(12) << "expanded"
+              << std::setw(14) << "avl ms" << std::setw(14) << "epoch ms" << "speedup" << std::endl;
+
+    for (int n : sizes) {
+        std::pair<int, int> start = {0, 0};
+        std::pair<int, int> end = {n - 1, n - 1};
+        std::vector<std::vector<int>> grid;
+        Maze maze = bench::randomMaze(n, 4, 7, &grid);
+
+        std::vector<std::pair<int, int>> oldPath, newPath;
+        Avl_Tree visitedCells;
+        double avl, epoch;
+        bench::quietly([&] {
+            avl = bench::millis([&] { oldPath = legacyWave(grid, visitedCells, start, end); });
+            // Первый вызов строит индекс компонент и буферы потока - не считаем его
+            maze.findPathWave(start, end);
+            epoch = bench::millis([&] { newPath = maze.findPathWave(start, end); });
+        });
+
+        if (oldPath.size() != newPath.size()) {
+            std::cout << "Path length mismatch at " << n << ": " << oldPath.size()
+                      << " vs " << newPath.size() << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(8) << n << std::setw(12) << maze.lastExpanded()
+                  << std::setw(14) << std::fixed << std::setprecision(1) << avl
+                  << std::setw(14) << epoch << std::setprecision(1) << avl / epoch << "x" << std::endl;
+    }
+    return 0;
+}
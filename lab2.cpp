@@ -1,4 +1,85 @@
 #include <iostream>
+#include <vector>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+// Пул объектов фиксированного размера: память берется блоками (slab) по
+// SLAB_SIZE ячеек, освобождённые ячейки идут в список свободных и выдаются
+// снова. release возвращает все блоки разом, без обхода объектов, поэтому
+// годится только для тривиально разрушаемых типов.
+template <typename T>
+class SlabPool {
+private:
+    static constexpr size_t SLAB_SIZE = 1024;
+
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<Slot*> slabs;
+    Slot* freeList = nullptr;
+    size_t used = SLAB_SIZE; // занятые ячейки последнего блока
+
+public:
+    SlabPool() {}
+    ~SlabPool() { release(); }
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+    SlabPool(SlabPool&& other) noexcept {
+        swap(other);
+    }
+    SlabPool& operator=(SlabPool&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot;
+        if (freeList) {
+            slot = freeList;
+            freeList = slot->next;
+        }
+        else {
+            if (used == SLAB_SIZE) {
+                slabs.push_back(new Slot[SLAB_SIZE]);
+                used = 0;
+            }
+            slot = &slabs.back()[used++];
+        }
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    void release() {
+        static_assert(std::is_trivially_destructible_v<T>);
+        for (Slot* slab : slabs) {
+            delete[] slab;
+        }
+        slabs.clear();
+        freeList = nullptr;
+        used = SLAB_SIZE;
+    }
+
+    void swap(SlabPool& other) {
+        std::swap(slabs, other.slabs);
+        std::swap(freeList, other.freeList);
+        std::swap(used, other.used);
+    }
+};
 
 class Avl_Tree {
 private:
@@ -7,21 +88,28 @@ private:
         Node* left;
         Node* right;
         int height;
-        Node(int k): key(k), left(nullptr), right(nullptr), height(1) {}
+        size_t size; // число узлов в поддереве, для порядковых запросов
+        Node(int k): key(k), left(nullptr), right(nullptr), height(1), size(1) {}
     };
     Node* root;
     size_t tree_size;
+    SlabPool<Node> pool; // все узлы дерева живут в его пуле
 
     int get_height(Node* node) {
         return node ? node->height : 0;
     }
+    static size_t get_size(const Node* node) {
+        return node ? node->size : 0;
+    }
     int max(int a, int b) {
         return (a > b) ? a : b;
     }
 
+    // Пересчитать высоту и размер поддерева по детям
     void updateHeight(Node* node) {
         if (node) {
             node->height = 1 + max(get_height(node->left), get_height(node->right));
+            node->size = 1 + get_size(node->left) + get_size(node->right);
         }
     }
 
@@ -74,134 +162,186 @@ private:
         return node;
     }
 
-    Node* insertNode(Node* node, int key, bool& inserted)  {
-        if (!node) {
-            inserted = true;
-            tree_size++;
-            return new Node(key);
-        }
-        if (key < node->key) {
-            node->left = insertNode(node->left, key, inserted);
+    // Высота AVL-дерева не больше 1.44 * log2(n + 2), так что для любого
+    // size_t хватает стека пути фиксированного размера
+    static constexpr int MAX_HEIGHT = 96;
+
+    // Подъем от места изменения к корню. path хранит адреса ссылок на узлы пути
+    // (root или поле left/right родителя), поэтому повороты сразу перевешивают
+    // поддерево. Когда высота поддерева после балансировки не изменилась,
+    // выше балансировать нечего - остается только поправить размеры на delta.
+    void rebalancePath(Node** path[], int depth, int delta) {
+        int i = depth - 1;
+        while (i >= 0) {
+            Node*& node = *path[i--];
+            int oldHeight = node->height;
+            node = balance(node);
+            if (node->height == oldHeight) break;
         }
-        else if (key > node->key) {
-            node->right = insertNode(node->right, key, inserted);
+        while (i >= 0) {
+            (*path[i--])->size += delta;
         }
-        else {
-            inserted = false;
-            return node;
-        }
-        return balance(node);
     }
 
-    Node* findMin(Node* node) {
-        while (node->left) {
-            node = node->left;
-        }
-        return node;
-    }
-
-    Node* deleteNode(Node* node, int key, bool& deleted, bool decrease_size = true) {
-        if (!node) {
-            deleted = false;
-            return nullptr;
-        }
-        if (key < node->key) {
-            node->left = deleteNode(node->left, key, deleted, decrease_size);
-        }
-        else if (key > node->key) {
-            node->right = deleteNode(node->right, key, deleted, decrease_size);
-        }
-        else {
-            deleted = true;
-            if (decrease_size) {
-                tree_size--;
-            }
-
-            if (!node->left || !node->right) {
-                Node* temp = node->left ? node->left : node->right;
-                delete node;
-                return temp;
+    bool insertNode(int key) {
+        Node** path[MAX_HEIGHT];
+        int depth = 0;
+        Node** link = &root;
+        while (*link) {
+            Node* node = *link;
+            if (key == node->key) {
+                return false;
             }
-            Node* temp = findMin(node->right);
-            node->key = temp->key;
-            // ВАЖНО: передаем false, чтобы не уменьшать size дважды
-            node->right = deleteNode(node->right, temp->key, deleted, false);
+            path[depth++] = link;
+            link = key < node->key ? &node->left : &node->right;
         }
-        return balance(node);
-    }
-
-    bool findNode(Node* node, int key) const {
+        *link = pool.create(key);
+        tree_size++;
+        rebalancePath(path, depth, +1);
+        return true;
+    }
+
+    bool deleteNode(int key) {
+        Node** path[MAX_HEIGHT];
+        int depth = 0;
+        Node** link = &root;
+        while (*link && (*link)->key != key) {
+            path[depth++] = link;
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+        }
+        Node* node = *link;
         if (!node) {
             return false;
         }
-        if (key < node->key) {
-            return findNode(node->left, key);
-        }
-        else if (key > node->key) {
-            return findNode(node->right, key);
+
+        if (node->left && node->right) {
+            // Два ребенка: забираем ключ преемника и удаляем его узел -
+            // у преемника нет левого ребенка
+            path[depth++] = link;
+            Node** successor = &node->right;
+            while ((*successor)->left) {
+                path[depth++] = successor;
+                successor = &(*successor)->left;
+            }
+            node->key = (*successor)->key;
+            link = successor;
+            node = *link;
         }
-        else {
-            return true;
+        *link = node->left ? node->left : node->right;
+        pool.destroy(node);
+        tree_size--;
+        rebalancePath(path, depth, -1);
+        return true;
+    }
+
+    bool findNode(int key) const {
+        const Node* node = root;
+        while (node) {
+            if (key == node->key) {
+                return true;
+            }
+            node = key < node->key ? node->left : node->right;
         }
+        return false;
     }
 
-    void clear(Node* node) {
-        if (node) {
-            clear(node->left);
-            clear(node->right);
-            delete node;
+    // Симметричный обход с явным стеком
+    void printTree() const {
+        std::vector<const Node*> stack;
+        const Node* node = root;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            std::cout << node->key << " ";
+            node = node->right;
         }
     }
 
-    void printTree(Node* node) const {
-        if (node) {
-            printTree(node->left);
-            std::cout << node->key << " ";
-            printTree(node->right);
+    int findIndex(int key) const {
+        int index = 0;
+        const Node* node = root;
+        while (node) {
+            if (key < node->key) {
+                node = node->left;
+            }
+            else if (key > node->key) {
+                index += 1 + get_size(node->left);
+                node = node->right;
+            }
+            else {
+                return index + get_size(node->left);
+            }
         }
+        return -1;
     }
-    int findIndex(Node* node, int key, int& index) const {
-        if (!node) {
-            return -1;
-        }
-        if (key < node->key) {
-            return findIndex(node->left, key, index);
-        }
-        else if (key > node->key) {
 
-            index += 1 + (node->left ? countNodes(node->left) : 0);
-            return findIndex(node->right, key, index);
+    // Идеально сбалансированное дерево из count различных ключей, идущих по
+    // возрастанию начиная с it (повторы пропускаются). Ключи берутся в
+    // симметричном порядке, так что входу хватает однопроходного чтения;
+    // глубина рекурсии - log2(count).
+    template <typename It>
+    Node* buildSorted(It& it, It end, size_t count) {
+        if (count == 0) {
+            return nullptr;
         }
-        else {
+        size_t leftCount = (count - 1) / 2;
+        Node* left = buildSorted(it, end, leftCount);
+        Node* node = pool.create(*it);
+        for (++it; it != end && *it == node->key; ++it) {}
+        node->left = left;
+        node->right = buildSorted(it, end, count - 1 - leftCount);
+        updateHeight(node);
+        return node;
+    }
 
-            index += (node->left ? countNodes(node->left) : 0);
-            return index;
+    // k-й по возрастанию ключ (с нуля): спуск по размерам поддеревьев
+    const Node* selectNode(const Node* node, size_t k) const {
+        while (node) {
+            size_t left = get_size(node->left);
+            if (k < left) {
+                node = node->left;
+            }
+            else if (k > left) {
+                k -= left + 1;
+                node = node->right;
+            }
+            else {
+                return node;
+            }
         }
-
-    }
-    int countNodes(Node* node) const {
-        if (!node) return 0;
-        return 1 + countNodes(node->left) + countNodes(node->right);
+        return nullptr;
     }
 
 public:
     Avl_Tree() : root(nullptr), tree_size(0) {}
-    ~Avl_Tree() { clear(root); }
+    // Произвольный диапазон: сортируем копию, убираем повторы и строим дерево целиком
+    template <std::input_iterator It>
+    Avl_Tree(It begin, It end) : root(nullptr), tree_size(0) {
+        std::vector<int> keys(begin, end);
+        std::sort(keys.begin(), keys.end());
+        assign_sorted(keys.begin(), keys.end());
+    }
+    Avl_Tree(Avl_Tree&& other) noexcept
+        : root(other.root), tree_size(other.tree_size), pool(std::move(other.pool)) {
+        other.root = nullptr;
+        other.tree_size = 0;
+    }
+    ~Avl_Tree() {}
 
     bool insert(int key) {
-        bool inserted = false;
-        root = insertNode(root, key, inserted);
-        return inserted;
+        return insertNode(key);
     }
 
     bool remove(int key) {
-        bool deleted = false;
-        root = deleteNode(root, key, deleted);
-        return deleted;
+        return deleteNode(key);
     }
 
     bool find(int key) const {
-        return findNode(root, key);
+        return findNode(key);
     }
 
     size_t size() const {
@@ -213,18 +353,57 @@ public:
     }
 
     void print() const {
-        printTree(root);
+        printTree();
         std::cout << std::endl;
     }
 
+    // Все узлы в пуле дерева - освобождаем блоки целиком, без обхода
     void clear_tree() {
-        clear(root);
+        pool.release();
         root = nullptr;
         tree_size = 0;
     }
+    // Заменить содержимое ключами из отсортированного диапазона за O(n):
+    // первый проход считает различные ключи, второй строит дерево.
+    // Если диапазон всё же не отсортирован, ключи сортируются в копии.
+    template <std::forward_iterator It>
+    void assign_sorted(It begin, It end) {
+        size_t unique = 0;
+        It prev = begin;
+        for (It it = begin; it != end; prev = it, ++it) {
+            if (it != begin && *it < *prev) {
+                std::vector<int> keys(begin, end);
+                std::sort(keys.begin(), keys.end());
+                assign_sorted(keys.begin(), keys.end());
+                return;
+            }
+            if (it == begin || *prev < *it) {
+                unique++;
+            }
+        }
+        clear_tree();
+        It it = begin;
+        root = buildSorted(it, end, unique);
+        tree_size = unique;
+    }
+
+    template <std::forward_iterator It>
+    static Avl_Tree from_sorted(It begin, It end) {
+        Avl_Tree tree;
+        tree.assign_sorted(begin, end);
+        return tree;
+    }
+
     int find_index(int key) const {
-        int index = 0;
-        return findIndex(root, key, index);
+        return findIndex(key);
+    }
+
+    // k-й по возрастанию ключ (с нуля) за O(log n); false, если k >= size()
+    bool select(size_t k, int& key) const {
+        const Node* node = selectNode(root, k);
+        if (!node) return false;
+        key = node->key;
+        return true;
     }
 };
 
@@ -234,6 +413,14 @@ private:
 
 public:
     set() {}
+    template <std::input_iterator It>
+    set(It begin, It end) : tree(begin, end) {}
+
+    // Заменить содержимое отсортированным диапазоном за O(n)
+    template <std::forward_iterator It>
+    void assign_sorted(It begin, It end) {
+        tree.assign_sorted(begin, end);
+    }
 
     bool insert(int key) {
         return tree.insert(key);
@@ -276,6 +463,11 @@ public:
         std::cout << result << std::endl;
         return result;
     }
+
+    // k-й по возрастанию элемент (с нуля)
+    bool select(size_t k, int& key) const {
+        return tree.select(k, key);
+    }
 };
 
 int main() {
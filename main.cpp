@@ -2,15 +2,111 @@
 #include <stack>
 #include <queue>
 #include <vector>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <mutex>
+
+// Пул объектов фиксированного размера: память берется блоками (slab) по
+// SLAB_SIZE ячеек, освобождённые ячейки идут в список свободных и выдаются
+// снова. release возвращает все блоки разом, без обхода объектов, поэтому
+// годится только для тривиально разрушаемых типов.
+template <typename T>
+class SlabPool {
+private:
+    static constexpr size_t SLAB_SIZE = 1024;
+
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<Slot*> slabs;
+    Slot* freeList = nullptr;
+    size_t used = SLAB_SIZE; // занятые ячейки последнего блока
+
+public:
+    SlabPool() {}
+    ~SlabPool() { release(); }
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+    SlabPool(SlabPool&& other) noexcept {
+        swap(other);
+    }
+    SlabPool& operator=(SlabPool&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot;
+        if (freeList) {
+            slot = freeList;
+            freeList = slot->next;
+        }
+        else {
+            if (used == SLAB_SIZE) {
+                slabs.push_back(new Slot[SLAB_SIZE]);
+                used = 0;
+            }
+            slot = &slabs.back()[used++];
+        }
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    void release() {
+        static_assert(std::is_trivially_destructible_v<T>);
+        for (Slot* slab : slabs) {
+            delete[] slab;
+        }
+        slabs.clear();
+        freeList = nullptr;
+        used = SLAB_SIZE;
+    }
+
+    void swap(SlabPool& other) {
+        std::swap(slabs, other.slabs);
+        std::swap(freeList, other.freeList);
+        std::swap(used, other.used);
+    }
+};
 
 class Node {
     int x;
     Node *left;
     Node *right;
+    // Общий пул узлов всех деревьев вместо new/delete на каждый узел. Деревья -
+    // голые указатели без владельца, поэтому пул один на программу и доступен
+    // только под poolLock: узлы можно создавать и освобождать из любого потока.
+    static SlabPool<Node>& pool() {
+        static SlabPool<Node> nodes;
+        return nodes;
+    }
+    static std::mutex& poolLock() {
+        static std::mutex lock;
+        return lock;
+    }
+
 public:
 
     Node* createNode(int x) {
-        Node* new_n = new Node();
+        Node* new_n;
+        {
+            std::lock_guard<std::mutex> guard(poolLock());
+            new_n = pool().create();
+        }
         new_n->x = x;
         new_n->left = nullptr;
         new_n->right = nullptr;
@@ -42,6 +138,39 @@ public:
         return n;
     }
 
+    // Сбалансированное дерево из отсортированного массива за O(n): середина
+    // диапазона - корень, половины - поддеревья. Стек хранит диапазоны и
+    // ссылку, куда подвесить построенный узел. Равные ключи, как и в insert,
+    // уходят вправо: корнем берётся первое вхождение ключа середины. Много
+    // повторов портят баланс, поэтому build их убирает
+    Node* buildSorted(const std::vector<int>& keys) {
+        Node* root = nullptr;
+        std::stack<std::pair<std::pair<size_t, size_t>, Node**>> s;
+        s.push({{0, keys.size()}, &root});
+        while(!s.empty()) {
+            auto [range, link] = s.top();
+            s.pop();
+            if(range.first >= range.second) {
+                continue;
+            }
+            size_t mid = range.first + (range.second - range.first) / 2;
+            mid = std::lower_bound(keys.begin() + range.first, keys.begin() + mid,
+                                   keys[mid]) - keys.begin();
+            Node* curr = createNode(keys[mid]);
+            *link = curr;
+            s.push({{mid + 1, range.second}, &curr->right});
+            s.push({{range.first, mid}, &curr->left});
+        }
+        return root;
+    }
+
+    // То же для произвольного набора ключей: сначала сортируем и убираем повторы
+    Node* build(std::vector<int> keys) {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return buildSorted(keys);
+    }
+
     void print(Node* n) {
         if(n == nullptr) {
             return;
@@ -67,6 +196,8 @@ public:
         }
         std::stack<Node*> s;
         s.push(n);
+        // Одна блокировка на всё дерево, а не на каждый узел
+        std::lock_guard<std::mutex> guard(poolLock());
         while(!s.empty()) {
             Node* curr = s.top();
             s.pop();
@@ -76,7 +207,7 @@ public:
             if(curr->right != nullptr) {
                 s.push(curr->right);
             }
-            delete curr;
+            pool().destroy(curr);
         }
         n = nullptr;
     }
@@ -140,6 +271,8 @@ public:
     }
 };
 
+// Бенчмарки подключают этот файл с NO_DEMO_MAIN, чтобы получить дерево без демо
+#ifndef NO_DEMO_MAIN
 int main() {
     Node node;
     Node* n = nullptr;
@@ -161,4 +294,5 @@ int main() {
     node.clear(n);
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -1,6 +1,7 @@
 #include <cassert>
 #include <iostream>
 #include <vector>
+#include <iterator>
 #include <queue>
 #include <stack>
 #include <utility>
@@ -9,6 +10,113 @@
 #include <algorithm>
 #include <iomanip>
 #include <set>
+#include <cstdint>
+#include <tuple>
+#include <bit>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <limits>
+#include <unordered_map>
+#include <chrono>
+#include <random>
+#include <array>
+#include <new>
+#include <type_traits>
+#include <list>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <numeric>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Пул объектов фиксированного размера: память берется блоками (slab) по
+// SLAB_SIZE ячеек, освобождённые ячейки идут в список свободных и выдаются
+// снова. release возвращает все блоки разом, без обхода объектов, поэтому
+// годится только для тривиально разрушаемых типов.
+template <typename T>
+class SlabPool {
+private:
+    static constexpr size_t SLAB_SIZE = 1024;
+
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<Slot*> slabs;
+    Slot* freeList = nullptr;
+    size_t used = SLAB_SIZE; // занятые ячейки последнего блока
+
+public:
+    SlabPool() {}
+    ~SlabPool() { release(); }
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+    SlabPool(SlabPool&& other) noexcept {
+        swap(other);
+    }
+    SlabPool& operator=(SlabPool&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot;
+        if (freeList) {
+            slot = freeList;
+            freeList = slot->next;
+        }
+        else {
+            if (used == SLAB_SIZE) {
+                slabs.push_back(new Slot[SLAB_SIZE]);
+                used = 0;
+            }
+            slot = &slabs.back()[used++];
+        }
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    void release() {
+        static_assert(std::is_trivially_destructible_v<T>);
+        for (Slot* slab : slabs) {
+            delete[] slab;
+        }
+        slabs.clear();
+        freeList = nullptr;
+        used = SLAB_SIZE;
+    }
+
+    void swap(SlabPool& other) {
+        std::swap(slabs, other.slabs);
+        std::swap(freeList, other.freeList);
+        std::swap(used, other.used);
+    }
+
+    // Память под блоки, включая свободные ячейки
+    size_t memoryBytes() const {
+        return slabs.size() * SLAB_SIZE * sizeof(Slot);
+    }
+};
 
 class Avl_Tree {
 private:
@@ -17,21 +125,28 @@ private:
         Node* left;
         Node* right;
         int height;
-        Node(int k): key(k), left(nullptr), right(nullptr), height(1) {}
+        size_t size; // число узлов в поддереве, для порядковых запросов
+        Node(int k): key(k), left(nullptr), right(nullptr), height(1), size(1) {}
     };
     Node* root;
     size_t tree_size;
+    SlabPool<Node> pool; // все узлы дерева живут в его пуле
 
     int get_height(Node* node) {
         return node ? node->height : 0;
     }
+    static size_t get_size(const Node* node) {
+        return node ? node->size : 0;
+    }
     int max(int a, int b) {
         return (a > b) ? a : b;
     }
 
+    // Пересчитать высоту и размер поддерева по детям
     void updateHeight(Node* node) {
         if (node) {
             node->height = 1 + max(get_height(node->left), get_height(node->right));
+            node->size = 1 + get_size(node->left) + get_size(node->right);
         }
     }
 
@@ -84,148 +199,215 @@ private:
         return node;
     }
 
-    Node* insertNode(Node* node, int key, bool& inserted)  {
-        if (!node) {
-            inserted = true;
-            tree_size++;
-            return new Node(key);
-        }
-        if (key < node->key) {
-            node->left = insertNode(node->left, key, inserted);
-        }
-        else if (key > node->key) {
-            node->right = insertNode(node->right, key, inserted);
+    // Высота AVL-дерева не больше 1.44 * log2(n + 2), так что для любого
+    // size_t хватает стека пути фиксированного размера
+    static constexpr int MAX_HEIGHT = 96;
+
+    // Подъем от места изменения к корню. path хранит адреса ссылок на узлы пути
+    // (root или поле left/right родителя), поэтому повороты сразу перевешивают
+    // поддерево. Когда высота поддерева после балансировки не изменилась,
+    // выше балансировать нечего - остается только поправить размеры на delta.
+    void rebalancePath(Node** path[], int depth, int delta) {
+        int i = depth - 1;
+        while (i >= 0) {
+            Node*& node = *path[i--];
+            int oldHeight = node->height;
+            node = balance(node);
+            if (node->height == oldHeight) break;
         }
-        else {
-            inserted = false;
-            return node;
+        while (i >= 0) {
+            (*path[i--])->size += delta;
         }
-        return balance(node);
     }
 
-    Node* findMin(Node* node) {
-        while (node->left) {
-            node = node->left;
+    bool insertNode(int key) {
+        Node** path[MAX_HEIGHT];
+        int depth = 0;
+        Node** link = &root;
+        while (*link) {
+            Node* node = *link;
+            if (key == node->key) {
+                return false;
+            }
+            path[depth++] = link;
+            link = key < node->key ? &node->left : &node->right;
         }
-        return node;
+        *link = pool.create(key);
+        tree_size++;
+        rebalancePath(path, depth, +1);
+        return true;
     }
 
-    Node* deleteNode(Node* node, int key, bool& deleted, bool decrease_size = true) {
-        if (!node) {
-            deleted = false;
-            return nullptr;
-        }
-        if (key < node->key) {
-            node->left = deleteNode(node->left, key, deleted, decrease_size);
+    bool deleteNode(int key) {
+        Node** path[MAX_HEIGHT];
+        int depth = 0;
+        Node** link = &root;
+        while (*link && (*link)->key != key) {
+            path[depth++] = link;
+            link = key < (*link)->key ? &(*link)->left : &(*link)->right;
         }
-        else if (key > node->key) {
-            node->right = deleteNode(node->right, key, deleted, decrease_size);
+        Node* node = *link;
+        if (!node) {
+            return false;
         }
-        else {
-            deleted = true;
-            if (decrease_size) {
-                tree_size--;
-            }
 
-            if (!node->left || !node->right) {
-                Node* temp = node->left ? node->left : node->right;
-                delete node;
-                return temp;
+        if (node->left && node->right) {
+            // Два ребенка: забираем ключ преемника и удаляем его узел -
+            // у преемника нет левого ребенка
+            path[depth++] = link;
+            Node** successor = &node->right;
+            while ((*successor)->left) {
+                path[depth++] = successor;
+                successor = &(*successor)->left;
             }
-            Node* temp = findMin(node->right);
-            node->key = temp->key;
-            node->right = deleteNode(node->right, temp->key, deleted, false);
+            node->key = (*successor)->key;
+            link = successor;
+            node = *link;
         }
-        return balance(node);
+        *link = node->left ? node->left : node->right;
+        pool.destroy(node);
+        tree_size--;
+        rebalancePath(path, depth, -1);
+        return true;
     }
 
-    bool findNode(Node* node, int key) const {
-        if (!node) {
-            return false;
-        }
-        if (key < node->key) {
-            return findNode(node->left, key);
-        }
-        if (key > node->key) {
-            return findNode(node->right, key);
-        }
-        {
-            return true;
+    bool findNode(int key) const {
+        const Node* node = root;
+        while (node) {
+            if (key == node->key) {
+                return true;
+            }
+            node = key < node->key ? node->left : node->right;
         }
+        return false;
     }
 
-    void clear(Node* node) {
-        if (node) {
-            clear(node->left);
-            clear(node->right);
-            delete node;
+    // Симметричный обход с явным стеком
+    void printTree() const {
+        std::vector<const Node*> stack;
+        const Node* node = root;
+        while (node || !stack.empty()) {
+            while (node) {
+                stack.push_back(node);
+                node = node->left;
+            }
+            node = stack.back();
+            stack.pop_back();
+            std::cout << node->key << " ";
+            node = node->right;
         }
     }
 
-    void printTree(Node* node) const {
-        if (node) {
-            printTree(node->left);
-            std::cout << node->key << " ";
-            printTree(node->right);
+    int findIndex(int key) const {
+        int index = 0;
+        const Node* node = root;
+        while (node) {
+            if (key < node->key) {
+                node = node->left;
+            }
+            else if (key > node->key) {
+                index += 1 + get_size(node->left);
+                node = node->right;
+            }
+            else {
+                return index + get_size(node->left);
+            }
         }
+        return -1;
     }
 
-    int findIndex(Node* node, int key, int& index) const {
-        if (!node) {
-            return -1;
-        }
-        if (key < node->key) {
-            return findIndex(node->left, key, index);
-        }
-        else if (key > node->key) {
-            index += 1 + (node->left ? countNodes(node->left) : 0);
-            return findIndex(node->right, key, index);
-        }
-        else {
-            index += (node->left ? countNodes(node->left) : 0);
-            return index;
+    // Идеально сбалансированное дерево из count различных ключей, идущих по
+    // возрастанию начиная с it (повторы пропускаются). Ключи берутся в
+    // симметричном порядке, так что входу хватает однопроходного чтения;
+    // глубина рекурсии - log2(count).
+    template <typename It>
+    Node* buildSorted(It& it, It end, size_t count) {
+        if (count == 0) {
+            return nullptr;
         }
+        size_t leftCount = (count - 1) / 2;
+        Node* left = buildSorted(it, end, leftCount);
+        Node* node = pool.create(*it);
+        for (++it; it != end && *it == node->key; ++it) {}
+        node->left = left;
+        node->right = buildSorted(it, end, count - 1 - leftCount);
+        updateHeight(node);
+        return node;
     }
 
-    int countNodes(Node* node) const {
-        if (!node) return 0;
-        return 1 + countNodes(node->left) + countNodes(node->right);
+    // k-й по возрастанию ключ (с нуля): спуск по размерам поддеревьев
+    const Node* selectNode(const Node* node, size_t k) const {
+        while (node) {
+            size_t left = get_size(node->left);
+            if (k < left) {
+                node = node->left;
+            }
+            else if (k > left) {
+                k -= left + 1;
+                node = node->right;
+            }
+            else {
+                return node;
+            }
+        }
+        return nullptr;
     }
 
-    bool isEqual(Node* a, Node* b) const {
-        if (!a && !b) return true;
-        if (!a || !b) return false;
-        return (a->key == b->key) &&
-               isEqual(a->left, b->left) &&
-               isEqual(a->right, b->right);
+    bool isEqual(const Node* a, const Node* b) const {
+        std::vector<std::pair<const Node*, const Node*>> stack;
+        stack.push_back({a, b});
+        while (!stack.empty()) {
+            auto [x, y] = stack.back();
+            stack.pop_back();
+            if (!x && !y) continue;
+            if (!x || !y || x->key != y->key) return false;
+            stack.push_back({x->right, y->right});
+            stack.push_back({x->left, y->left});
+        }
+        return true;
     }
-    Node* copyTree(Node* node) {
-        if (!node) return nullptr;
-        Node* newNode = new Node(node->key);
-        newNode->height = node->height;
-        newNode->left = copyTree(node->left);
-        newNode->right = copyTree(node->right);
-        return newNode;
+
+    // Копирование в прямом порядке: в стеке пары (исходный узел, куда записать копию)
+    Node* copyTree(const Node* node) {
+        Node* result = nullptr;
+        std::vector<std::pair<const Node*, Node**>> stack;
+        stack.push_back({node, &result});
+        while (!stack.empty()) {
+            auto [source, link] = stack.back();
+            stack.pop_back();
+            if (!source) continue;
+            Node* newNode = pool.create(source->key);
+            newNode->height = source->height;
+            newNode->size = source->size;
+            *link = newNode;
+            stack.push_back({source->right, &newNode->right});
+            stack.push_back({source->left, &newNode->left});
+        }
+        return result;
     }
 
 public:
-    ~Avl_Tree() { clear(root); }
+    ~Avl_Tree() {}
     Avl_Tree() : root(nullptr), tree_size(0) {}
-    Avl_Tree(const std::initializer_list<int>& a) : root(nullptr), tree_size(0) {
-        for (auto e : a) {
-            insert(e);
-        }
+    Avl_Tree(const std::initializer_list<int>& a) : Avl_Tree(a.begin(), a.end()) {}
+    // Произвольный диапазон: сортируем копию, убираем повторы и строим дерево целиком
+    template <std::input_iterator It>
+    Avl_Tree(It begin, It end) : root(nullptr), tree_size(0) {
+        std::vector<int> keys(begin, end);
+        std::sort(keys.begin(), keys.end());
+        assign_sorted(keys.begin(), keys.end());
     }
     Avl_Tree(const Avl_Tree& other) : root(nullptr), tree_size(other.tree_size) {
         root = copyTree(other.root);
     }
-    Avl_Tree(Avl_Tree&& other) noexcept : root(other.root), tree_size(other.tree_size) {
+    Avl_Tree(Avl_Tree&& other) noexcept
+        : root(other.root), tree_size(other.tree_size), pool(std::move(other.pool)) {
         other.root = nullptr;
         other.tree_size = 0;
     }
     Avl_Tree& operator=(const Avl_Tree& other) {
         if (this != &other) {
-            clear(root);
+            pool.release();
             root = copyTree(other.root);
             tree_size = other.tree_size;
         }
@@ -233,7 +415,7 @@ public:
     }
     Avl_Tree& operator=(Avl_Tree&& other)  {
         if (this != &other) {
-            clear(root);
+            pool = std::move(other.pool);
             root = other.root;
             tree_size = other.tree_size;
             other.root = nullptr;
@@ -242,47 +424,87 @@ public:
         return *this;
     }
     bool insert(int key) {
-        bool inserted = false;
-        root = insertNode(root, key, inserted);
-        return inserted;
+        return insertNode(key);
     }
 
     bool remove(int key) {
-        bool deleted = false;
-        root = deleteNode(root, key, deleted);
-        return deleted;
+        return deleteNode(key);
     }
 
     bool contains(int key) const {
-        return findNode(root, key);
+        return findNode(key);
     }
 
     size_t size() const {
         return tree_size;
     }
 
+    size_t memoryBytes() const {
+        return pool.memoryBytes();
+    }
+
     bool empty() const {
         return tree_size == 0;
     }
 
     void print() const {
-        printTree(root);
+        printTree();
         std::cout << std::endl;
     }
 
+    // Все узлы в пуле дерева - освобождаем блоки целиком, без обхода
     void clear() {
-        clear(root);
+        pool.release();
         root = nullptr;
         tree_size = 0;
     }
 
+    // Заменить содержимое ключами из отсортированного диапазона за O(n):
+    // первый проход считает различные ключи, второй строит дерево.
+    // Если диапазон всё же не отсортирован, ключи сортируются в копии.
+    template <std::forward_iterator It>
+    void assign_sorted(It begin, It end) {
+        size_t unique = 0;
+        It prev = begin;
+        for (It it = begin; it != end; prev = it, ++it) {
+            if (it != begin && *it < *prev) {
+                std::vector<int> keys(begin, end);
+                std::sort(keys.begin(), keys.end());
+                assign_sorted(keys.begin(), keys.end());
+                return;
+            }
+            if (it == begin || *prev < *it) {
+                unique++;
+            }
+        }
+        clear();
+        It it = begin;
+        root = buildSorted(it, end, unique);
+        tree_size = unique;
+    }
+
+    template <std::forward_iterator It>
+    static Avl_Tree from_sorted(It begin, It end) {
+        Avl_Tree tree;
+        tree.assign_sorted(begin, end);
+        return tree;
+    }
+
     int get_index(int key) const {
-        int index = 0;
-        return findIndex(root, key, index);
+        return findIndex(key);
+    }
+
+    // k-й по возрастанию ключ (с нуля) за O(log n); false, если k >= size()
+    bool select(size_t k, int& key) const {
+        const Node* node = selectNode(root, k);
+        if (!node) return false;
+        key = node->key;
+        return true;
     }
 
     void swap(Avl_Tree& other) {
         std::swap(root, other.root);
+        pool.swap(other.pool);
         std::swap(tree_size, other.tree_size);
     }
 
@@ -292,337 +514,3554 @@ public:
     }
 };
 
-class Maze {
+// Компактный вариант Avl_Tree: все узлы в одном непрерывном векторе,
+// дети - 32-битные индексы, высота - один байт; узел занимает 16 байт вместо
+// 40 у Avl_Tree. Индекс 0 - общий пустой узел с высотой 0, поэтому проверки
+// на nullptr не нужны. Удалённые ячейки переиспользуются через список свободных.
+// Индексы ограничивают дерево 2^32 - 1 узлами. Интерфейс тот же: insert, remove,
+// contains, size, empty, clear, print.
+class CompactAvlTree {
 private:
-    std::vector<std::vector<int>> grid;
-    Avl_Tree visitedCells;
-    int rows, cols;
+    static constexpr uint32_t NIL = 0;
 
-    int coordToKey(int x, int y) const {
-        return x * cols + y;
+    struct Node {
+        int key;
+        uint32_t left;
+        uint32_t right;
+        int8_t height;
+    };
+
+    std::vector<Node> nodes;
+    uint32_t root = NIL;
+    uint32_t freeList = NIL; // свободные ячейки связаны через left
+    size_t tree_size = 0;
+
+    int get_height(uint32_t node) const {
+        return nodes[node].height;
     }
 
-    std::pair<int, int> keyToCoord(int key) const {
-        return {key / cols, key % cols};
+    void updateHeight(uint32_t node) {
+        nodes[node].height = 1 + std::max(get_height(nodes[node].left), get_height(nodes[node].right));
     }
 
-    bool isValid(int x, int y) const {
-        return x >= 0 && x < rows && y >= 0 && y < cols;
+    int getBalance(uint32_t node) const {
+        return get_height(nodes[node].left) - get_height(nodes[node].right);
     }
 
-    bool isPassable(int x, int y) const {
-        return isValid(x, y) && grid[x][y] == 0;
+    uint32_t newNode(int key) {
+        uint32_t node = freeList;
+        if (node != NIL) {
+            freeList = nodes[node].left;
+        }
+        else {
+            node = nodes.size();
+            nodes.push_back({});
+        }
+        nodes[node] = {key, NIL, NIL, 1};
+        return node;
     }
 
-    // Проверка, является ли клетка тупиком
-    bool isDeadEnd(int x, int y) const {
-        if (grid[x][y] == 1) return false; // Стена не может быть тупиком
+    void freeNode(uint32_t node) {
+        nodes[node].left = freeList;
+        freeList = node;
+    }
 
-        int passageCount = 0;
-        const int dx[4] = {-1, 0, 1, 0};
-        const int dy[4] = {0, 1, 0, -1};
+    uint32_t rotateR(uint32_t y) {
+        uint32_t x = nodes[y].left;
+        nodes[y].left = nodes[x].right;
+        nodes[x].right = y;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
 
-        for (int i = 0; i < 4; i++) {
-            int nx = x + dx[i];
-            int ny = y + dy[i];
-            if (isValid(nx, ny) && grid[nx][ny] == 0) {
-                passageCount++;
+    uint32_t rotateL(uint32_t x) {
+        uint32_t y = nodes[x].right;
+        nodes[x].right = nodes[y].left;
+        nodes[y].left = x;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    uint32_t balance(uint32_t node) {
+        updateHeight(node);
+        int bal = getBalance(node);
+
+        if (bal > 1) {
+            if (getBalance(nodes[node].left) < 0) {
+                nodes[node].left = rotateL(nodes[node].left);
+            }
+            return rotateR(node);
+        }
+        if (bal < -1) {
+            if (getBalance(nodes[node].right) > 0) {
+                nodes[node].right = rotateR(nodes[node].right);
             }
+            return rotateL(node);
         }
-
-        // Тупик имеет только 1 проход
-        return passageCount == 1;
+        return node;
     }
 
-    // Получить количество соседей-проходов
-    int countPassageNeighbors(int x, int y) const {
-        int count = 0;
-        const int dx[4] = {-1, 0, 1, 0};
-        const int dy[4] = {0, 1, 0, -1};
+    // Ссылки на nodes нельзя держать через рекурсию: newNode может расширить вектор
+    uint32_t insertNode(uint32_t node, int key, bool& inserted) {
+        if (node == NIL) {
+            inserted = true;
+            tree_size++;
+            return newNode(key);
+        }
+        if (key < nodes[node].key) {
+            uint32_t child = insertNode(nodes[node].left, key, inserted);
+            nodes[node].left = child;
+        }
+        else if (key > nodes[node].key) {
+            uint32_t child = insertNode(nodes[node].right, key, inserted);
+            nodes[node].right = child;
+        }
+        else {
+            inserted = false;
+            return node;
+        }
+        return inserted ? balance(node) : node;
+    }
 
-        for (int i = 0; i < 4; i++) {
-            int nx = x + dx[i];
-            int ny = y + dy[i];
-            if (isValid(nx, ny) && grid[nx][ny] == 0) {
-                count++;
+    uint32_t deleteNode(uint32_t node, int key, bool& deleted) {
+        if (node == NIL) {
+            deleted = false;
+            return NIL;
+        }
+        if (key < nodes[node].key) {
+            nodes[node].left = deleteNode(nodes[node].left, key, deleted);
+        }
+        else if (key > nodes[node].key) {
+            nodes[node].right = deleteNode(nodes[node].right, key, deleted);
+        }
+        else {
+            deleted = true;
+            if (nodes[node].left == NIL || nodes[node].right == NIL) {
+                uint32_t child = nodes[node].left != NIL ? nodes[node].left : nodes[node].right;
+                freeNode(node);
+                return child;
             }
+            uint32_t next = nodes[node].right;
+            while (nodes[next].left != NIL) {
+                next = nodes[next].left;
+            }
+            nodes[node].key = nodes[next].key;
+            nodes[node].right = deleteNode(nodes[node].right, nodes[next].key, deleted);
+        }
+        return deleted ? balance(node) : node;
+    }
+
+    void printTree(uint32_t node) const {
+        if (node != NIL) {
+            printTree(nodes[node].left);
+            std::cout << nodes[node].key << " ";
+            printTree(nodes[node].right);
         }
-        return count;
     }
 
 public:
-    Maze() : rows(0), cols(0) {}
-    Maze(const std::vector<std::vector<int>>& maze) : grid(maze) {
-        rows = maze.size();
-        cols = maze.empty() ? 0 : maze[0].size();
+    CompactAvlTree() {
+        clear();
     }
-    Maze(int r, int c) : rows(r), cols(c) {
-        grid.resize(r, std::vector<int>(c, 0));
+
+    bool insert(int key) {
+        bool inserted = false;
+        root = insertNode(root, key, inserted);
+        return inserted;
     }
 
-    void setGrid(const std::vector<std::vector<int>>& maze) {
-        grid = maze;
-        rows = maze.size();
-        cols = maze.empty() ? 0 : maze[0].size();
-        visitedCells.clear();
+    bool remove(int key) {
+        bool deleted = false;
+        root = deleteNode(root, key, deleted);
+        if (deleted) tree_size--;
+        return deleted;
     }
 
-    void setCell(int x, int y, int value) {
-        if (isValid(x, y)) {
-            grid[x][y] = value;
+    bool contains(int key) const {
+        uint32_t node = root;
+        while (node != NIL) {
+            const Node& n = nodes[node];
+            if (key == n.key) return true;
+            node = key < n.key ? n.left : n.right;
         }
+        return false;
     }
 
-    // BRAIDING ALGORITHM - устранение тупиков
-    void braidMaze(double braidFactor = 0.5) {
-        std::cout << "\n=== APPLYING BRAIDING ALGORITHM ===" << std::endl;
-        std::cout << "Braid factor: " << braidFactor << std::endl;
-
-        std::vector<std::pair<int, int>> deadEnds;
+    size_t size() const {
+        return tree_size;
+    }
 
-        // Находим все тупики
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                if (isDeadEnd(i, j)) {
-                    deadEnds.push_back({i, j});
-                }
-            }
-        }
+    bool empty() const {
+        return tree_size == 0;
+    }
 
-        std::cout << "Found " << deadEnds.size() << " dead ends" << std::endl;
+    void print() const {
+        printTree(root);
+        std::cout << std::endl;
+    }
 
-        // "Зашиваем" случайные тупики в соответствии с braidFactor
-        std::random_shuffle(deadEnds.begin(), deadEnds.end());
-        int braidCount = static_cast<int>(deadEnds.size() * braidFactor);
+    void clear() {
+        nodes.assign(1, Node{0, NIL, NIL, 0});
+        root = NIL;
+        freeList = NIL;
+        tree_size = 0;
+    }
 
-        for (int i = 0; i < braidCount && i < deadEnds.size(); i++) {
-            auto [x, y] = deadEnds[i];
-            braidDeadEnd(x, y);
-        }
+    // Зарезервировать место под count ключей, чтобы вектор не переезжал при вставках
+    void reserve(size_t count) {
+        nodes.reserve(count + 1);
+    }
 
-        std::cout << "Braided " << braidCount << " dead ends" << std::endl;
+    size_t memoryBytes() const {
+        return nodes.capacity() * sizeof(Node);
     }
+};
 
+// Пул потоков с перехватом задач (work stealing).
+// У каждого потока своя дека задач: владелец берёт задачи с конца,
+// а освободившийся поток крадёт их с начала чужой деки.
+// Потоки живут всё время жизни пула, поэтому их thread_local буферы
+// переиспользуются между вызовами run.
+class WorkStealingPool {
 private:
-    // "Зашивание" конкретного тупика
-    void braidDeadEnd(int x, int y) {
-        const int dx[4] = {-1, 0, 1, 0};
-        const int dy[4] = {0, 1, 0, -1};
+    struct TaskDeque {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
 
-        // Находим стену, которую можно убрать чтобы соединить с другим проходом
-        for (int i = 0; i < 4; i++) {
-            int nx = x + dx[i];
-            int ny = y + dy[i];
+    std::vector<std::unique_ptr<TaskDeque>> deques;
+    std::vector<std::thread> threads;
+    // Один run за раз: job, remaining и деки общие для всех вызывающих
+    std::mutex runLock;
+    std::mutex stateLock;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* job = nullptr;
+    std::atomic<size_t> remaining{0};
+    size_t generation = 0;
+    bool stopping = false;
 
-            if (isValid(nx, ny) && grid[nx][ny] == 1) {
-                // Проверяем, не создаст ли это слишком много соединений
-                int newConnections = 0;
-                for (int j = 0; j < 4; j++) {
-                    int nnx = nx + dx[j];
-                    int nny = ny + dy[j];
-                    if (isValid(nnx, nny) && grid[nnx][nny] == 0) {
-                        newConnections++;
-                    }
-                }
+    // Пул, задачи которого сейчас выполняет этот поток (его рабочий или вызывающий run)
+    static const WorkStealingPool*& currentPool() {
+        thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
 
-                // Если убирание стены создает разумное количество соединений
-                if (newConnections >= 1 && newConnections <= 2) {
-                    grid[nx][ny] = 0; // Убираем стену
-                    std::cout << "  Braided: (" << x << "," << y << ") -> (" << nx << "," << ny << ")" << std::endl;
-                    return;
-                }
+    bool takeTask(unsigned self, size_t& task) {
+        {
+            TaskDeque& own = *deques[self];
+            std::lock_guard<std::mutex> guard(own.lock);
+            if (!own.tasks.empty()) {
+                task = own.tasks.back();
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < deques.size(); k++) {
+            TaskDeque& victim = *deques[(self + k) % deques.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
             }
         }
+        return false;
     }
 
-public:
-    // Wave Algorithm (Branding Algorithm)
-    std::vector<std::pair<int, int>> findPathWave(std::pair<int, int> start,
-                                                 std::pair<int, int> end) {
-        if (!isPassable(start.first, start.second) ||
-            !isPassable(end.first, end.second)) {
-            std::cout << "Start or end position is blocked!" << std::endl;
-            return {};
+    void drain(unsigned self) {
+        size_t task;
+        while (takeTask(self, task)) {
+            (*job)(task);
+            if (--remaining == 0) {
+                std::lock_guard<std::mutex> guard(stateLock);
+                finished.notify_all();
+            }
         }
+    }
 
-        std::vector<std::vector<int>> wave(rows, std::vector<int>(cols, -1));
-        std::vector<std::vector<std::pair<int, int>>> parent(rows,
-            std::vector<std::pair<int, int>>(cols, {-1, -1}));
-
-        std::queue<std::pair<int, int>> q;
-
-        wave[start.first][start.second] = 0;
-        q.push(start);
-
-        const int dx[4] = {-1, 0, 1, 0};
-        const int dy[4] = {0, 1, 0, -1};
+    void workerLoop(unsigned self) {
+        currentPool() = this;
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(stateLock);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            drain(self);
+        }
+    }
 
-        bool found = false;
+public:
+    // threads == 0 - по числу ядер; вызывающий поток тоже выполняет задачи
+    explicit WorkStealingPool(unsigned threadCount = 0) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 0; i < threadCount; i++) {
+            deques.push_back(std::make_unique<TaskDeque>());
+        }
+        for (unsigned i = 1; i < threadCount; i++) {
+            threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
 
-        while (!q.empty() && !found) {
-            auto [x, y] = q.front();
-            q.pop();
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(stateLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
 
-            if (x == end.first && y == end.second) {
-                found = true;
-                break;
-            }
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
 
-            for (int i = 0; i < 4; i++) {
-                int nx = x + dx[i];
-                int ny = y + dy[i];
+    unsigned size() const {
+        return deques.size();
+    }
 
-                if (isPassable(nx, ny) && wave[nx][ny] == -1) {
-                    wave[nx][ny] = wave[x][y] + 1;
-                    parent[nx][ny] = {x, y};
-                    q.push({nx, ny});
-                    visitedCells.insert(coordToKey(nx, ny));
-                }
+    // Выполнить task(i) для всех i из [0, taskCount) и дождаться завершения.
+    // Вызовы из разных потоков выполняются по очереди. Вложенный run (из задачи
+    // этого же пула) выполняет свои задачи сразу в текущем потоке - иначе
+    // он ждал бы сам себя.
+    void run(size_t taskCount, const std::function<void(size_t)>& task) {
+        if (taskCount == 0) return;
+        if (currentPool() == this) {
+            for (size_t i = 0; i < taskCount; i++) {
+                task(i);
             }
+            return;
         }
 
-        if (!found) {
-            std::cout << "No path found by wave algorithm!" << std::endl;
-            return {};
+        std::lock_guard<std::mutex> serial(runLock);
+        const WorkStealingPool* outer = currentPool();
+        currentPool() = this;
+        job = &task;
+        remaining = taskCount;
+        for (size_t i = 0; i < taskCount; i++) {
+            TaskDeque& d = *deques[i % deques.size()];
+            std::lock_guard<std::mutex> guard(d.lock);
+            d.tasks.push_back(i);
         }
+        {
+            std::lock_guard<std::mutex> guard(stateLock);
+            generation++;
+        }
+        wake.notify_all();
+
+        drain(0);
+        std::unique_lock<std::mutex> lock(stateLock);
+        finished.wait(lock, [&] { return remaining == 0; });
+        job = nullptr;
+        currentPool() = outer;
+    }
+};
+
+// Сводная статистика лабиринта, пригодная для сбора в мониторинге.
+// degrees[k] - число проходимых клеток ровно с k проходимыми соседями,
+// так что degrees[1] совпадает с числом тупиков.
+struct MazeStats {
+    int rows = 0;
+    int cols = 0;
+    size_t passable = 0;
+    size_t deadEnds = 0;
+    size_t components = 0;
+    std::array<size_t, 5> degrees{};
+};
+
+// Результат поиска по взвешенной сетке: путь в обычном формате и его стоимость
+// (сумма стоимостей клеток пути без стартовой)
+struct WeightedPath {
+    std::vector<std::pair<int, int>> path;
+    int64_t cost = -1;
+};
+
+// Пороги переключения параллельной волны (Maze::parallelWave) между обходом
+// "сверху вниз" (от фронта) и "снизу вверх" (от непосещённых клеток).
+// Уровень bottom-up просматривает все клетки сетки, поэтому окупается, только
+// когда фронт - заметная доля всех проходов; на больших 2D-сетках фронт - линия,
+// и bottom-up почти не включается. topDown = 0 отключает его совсем.
+// Значения по умолчанию подобраны бенчмарком bench_parallel_wave.cpp.
+struct WaveSwitch {
+    size_t topDown = 16;  // переход к bottom-up: фронт * topDown > всех проходов
+    size_t bottomUp = 24; // возврат к top-down: фронт * bottomUp < всех проходов
+};
+
+// Поле расстояний до ближайшего источника (Maze::multiSourceDistances).
+// Массивы лежат в раскладке буфера стен с рамкой, так что запрос по клетке -
+// одно обращение по ключу. Для стен, клеток вне сетки и недостижимых
+// клеток distance и nearestSource возвращают -1.
+class DistanceField {
+private:
+    friend class Maze;
+
+    int rows = 0, cols = 0, stride = 0;
+    std::vector<int> dist;
+    std::vector<int> label; // индекс ближайшего источника в sources
+    std::vector<std::pair<int, int>> sources;
+
+    int keyOf(int x, int y) const {
+        if (x < 0 || x >= rows || y < 0 || y >= cols) return -1;
+        return (x + 1) * stride + (y + 1);
+    }
+
+public:
+    int distance(int x, int y) const {
+        int key = keyOf(x, y);
+        return key < 0 ? -1 : dist[key];
+    }
+
+    // Индекс ближайшего источника в списке, переданном при построении
+    int nearestSource(int x, int y) const {
+        int key = keyOf(x, y);
+        return key < 0 ? -1 : label[key];
+    }
+
+    // Координаты ближайшего источника или (-1, -1)
+    std::pair<int, int> nearestSourceCell(int x, int y) const {
+        int index = nearestSource(x, y);
+        return index < 0 ? std::make_pair(-1, -1) : sources[index];
+    }
+};
+
+class Maze {
+private:
+    friend class IncrementalPlanner;
+    friend class HierarchicalIndex;
+    friend class MazeGenerator;
+
+    // Рабочие буферы одного поиска. Метки эпох позволяют не очищать массивы
+    // между запросами; у каждого потока свой экземпляр (threadWorkspace).
+    struct SearchWorkspace {
+        std::vector<uint32_t> stamp;
+        std::vector<uint32_t> targetStamp;
+        std::vector<int> parent;
+        std::vector<int> queue;
+        // Номер волны (длина пути от старта) для посещённых клеток
+        std::vector<int> dist;
+        // Обратная волна двунаправленного поиска (та же эпоха, что и stamp)
+        std::vector<uint32_t> backStamp;
+        std::vector<int> backParent;
+        std::vector<int> backDist;
+        // Битовые фронты волны (раскладка как у буфера стен) и списки активных слов
+        std::vector<uint64_t> frontierBits;
+        std::vector<uint64_t> nextBits;
+        std::vector<uint64_t> blockedBits;
+        std::vector<int> activeWords;
+        std::vector<int> nextActiveWords;
+        // Стоимости и кольцо корзин поиска Дейкстры (Dial)
+        std::vector<int64_t> costDist;
+        std::vector<std::vector<int>> buckets;
+        uint32_t epoch = 0;
+
+        // Остальные массивы алгоритмы досоздают сами (resize), когда они нужны
+        void begin(size_t cells) {
+            if (stamp.size() != cells) {
+                stamp.assign(cells, 0);
+                targetStamp.assign(cells, 0);
+                parent.resize(cells);
+                queue.resize(cells);
+                dist.clear();
+                backStamp.clear();
+                backParent.clear();
+                backDist.clear();
+                epoch = 0;
+            }
+            if (++epoch == 0) {
+                std::fill(stamp.begin(), stamp.end(), 0);
+                std::fill(targetStamp.begin(), targetStamp.end(), 0);
+                std::fill(backStamp.begin(), backStamp.end(), 0);
+                epoch = 1;
+            }
+        }
+
+        bool visited(int key) const {
+            return stamp[key] == epoch;
+        }
+    };
+
+    static SearchWorkspace& threadWorkspace() {
+        thread_local SearchWorkspace workspace;
+        return workspace;
+    }
+
+    // Стены хранятся битами (1 - стена) в одном непрерывном буфере по строкам.
+    // Лабиринт окружён рамкой из стен, поэтому у любой внутренней клетки все
+    // четыре соседа лежат в буфере и проверять границы в циклах не нужно.
+    // Длина строки (stride) кратна 64, так что каждая строка начинается с нового слова.
+    // wallBits указывает либо на собственный буфер walls, либо на отображённый
+    // в память файл (loadMapped) - поиски работают с ним одинаково.
+    std::vector<uint64_t> walls;
+    uint64_t* wallBits = nullptr;
+    void* mappedAddress = nullptr;
+    size_t mappedLength = 0;
+    // Стоимость входа в клетку (1..MAX_COST) в той же раскладке с рамкой.
+    // Пустой слой - все стоимости равны 1; стены по-прежнему хранит wallBits.
+    // costCounts - сколько клеток слоя имеют каждую стоимость: по нему maxCost
+    // опускается, когда подешевела последняя самая дорогая клетка.
+    static constexpr int MAX_COST = 255;
+    std::vector<uint8_t> costs;
+    std::array<size_t, MAX_COST + 1> costCounts{};
+    int maxCost = 1;
+    // Статистика последнего поиска. Поиски константны и не трогают общих буферов
+    // (всё рабочее состояние - в SearchWorkspace потока), поэтому их можно
+    // вызывать из нескольких потоков одновременно.
+    mutable std::atomic<size_t> visitedCount{0};
+    mutable std::atomic<size_t> expandedCount{0};
+    // Индекс компонент связности: метка для каждого прохода (-1 для стен) и
+    // система непересекающихся множеств над метками - открытая клетка сливает
+    // компоненты соседей без пересчёта сетки (setCell).
+    // Missing - индекса нет (gridChanged или разрез, не уложившийся в бюджет):
+    // его перестраивает первый же запрос - поиск, sameComponent или componentCount.
+    enum class ComponentIndex : uint8_t { Missing, Valid };
+    mutable std::vector<int> componentLabel;
+    mutable std::vector<int> componentParent;
+    mutable std::vector<uint8_t> componentRank;
+    mutable size_t components = 0;
+    mutable std::atomic<ComponentIndex> componentState{ComponentIndex::Missing};
+    mutable std::mutex componentLock;
+    // Версия сетки: растёт при каждом изменении (gridChanged), по ней
+    // внешние кэши узнают, что их результаты устарели
+    std::atomic<uint64_t> gridVersion{0};
+    int rows, cols;
+    int stride;
+
+    // Ключ клетки - её индекс в буфере с рамкой
+    int coordToKey(int x, int y) const {
+        return (x + 1) * stride + (y + 1);
+    }
+
+    std::pair<int, int> keyToCoord(int key) const {
+        return {key / stride - 1, key % stride - 1};
+    }
+
+    size_t cellCount() const {
+        return static_cast<size_t>(rows + 2) * stride;
+    }
+
+    size_t wordCount() const {
+        return cellCount() / 64;
+    }
+
+    bool isWall(int key) const {
+        return (wallBits[key >> 6] >> (key & 63)) & 1;
+    }
+
+    void setWall(int key, bool wall) {
+        if (wall) {
+            wallBits[key >> 6] |= uint64_t(1) << (key & 63);
+        } else {
+            wallBits[key >> 6] &= ~(uint64_t(1) << (key & 63));
+        }
+    }
+
+    void unmap() {
+        if (mappedAddress) {
+            munmap(mappedAddress, mappedLength);
+            mappedAddress = nullptr;
+            mappedLength = 0;
+        }
+    }
+
+    // Пересчитать costCounts и maxCost по всему слою стоимостей
+    void recountCosts() {
+        costCounts.fill(0);
+        for (uint8_t cost : costs) costCounts[cost]++;
+        maxCost = 1;
+        for (int cost = MAX_COST; cost > 1; cost--) {
+            if (costCounts[cost]) {
+                maxCost = cost;
+                break;
+            }
+        }
+    }
+
+    // Сменить стоимость одной клетки слоя, поддерживая costCounts и maxCost
+    void assignCost(int key, int cost) {
+        costCounts[costs[key]]--;
+        costs[key] = cost;
+        costCounts[cost]++;
+        maxCost = std::max(maxCost, cost);
+        while (maxCost > 1 && costCounts[maxCost] == 0) maxCost--;
+    }
+
+    // Заголовок файла лабиринта; за ним идут wordCount слов сетки с рамкой,
+    // в том же виде, что и в памяти (порядок байт - как у машины). С флагом
+    // FILE_COSTS следом лежит слой стоимостей: cellCount() байт в той же раскладке.
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        int32_t rows;
+        int32_t cols;
+        int32_t stride;
+        uint32_t flags;
+        uint64_t wordCount;
+    };
+    static constexpr char FILE_MAGIC[8] = {'M', 'A', 'Z', 'E', 'B', 'I', 'T', 'S'};
+    static constexpr uint32_t FILE_VERSION = 1;
+    static constexpr uint32_t FILE_COSTS = 1;
+
+    // Смещения ключа к соседям в порядке dx/dy: вверх, вправо, вниз, влево
+    void neighborOffsets(int offsets[4]) const {
+        offsets[0] = -stride;
+        offsets[1] = 1;
+        offsets[2] = stride;
+        offsets[3] = -1;
+    }
+
+    // Сетка изменилась - сбрасываем всё, что вычислено по ней
+    void gridChanged() {
+        componentState.store(ComponentIndex::Missing, std::memory_order_release);
+        gridVersion.fetch_add(1, std::memory_order_release);
+    }
+
+    // Одна клетка сменила проходимость: поправить индекс компонент без полного
+    // пересчёта. Открытая клетка объединяет компоненты соседей. Новая стена
+    // могла разрезать компоненту - тогда от её соседей идёт волна с бюджетом
+    // в 1/64 сетки (не меньше MIN_SPLIT_BUDGET клеток): соседи, которые нашли
+    // друг друга, остались вместе, а область, исчерпанная до конца, получает
+    // новую метку. Только если бюджета не хватило, индекс сбрасывается.
+    static constexpr size_t MIN_SPLIT_BUDGET = 4096;
+
+    void cellChanged(int key) {
+        if (componentState.load(std::memory_order_relaxed) == ComponentIndex::Valid) {
+            int offsets[4];
+            neighborOffsets(offsets);
+            if (!isWall(key)) {
+                int root = -1;
+                for (int d = 0; d < 4; d++) {
+                    int nkey = key + offsets[d];
+                    if (isWall(nkey)) continue;
+                    int r = findComponent(componentLabel[nkey]);
+                    root = root == -1 ? r : uniteComponents(root, r);
+                }
+                if (root == -1) {
+                    root = componentParent.size();
+                    componentParent.push_back(root);
+                    componentRank.push_back(0);
+                    components++;
+                }
+                componentLabel[key] = root;
+            } else {
+                std::vector<int> open;
+                for (int d = 0; d < 4; d++) {
+                    if (!isWall(key + offsets[d])) open.push_back(key + offsets[d]);
+                }
+                componentLabel[key] = -1;
+                if (open.empty()) {
+                    components--;
+                } else if (!splitComponent(open)) {
+                    componentState.store(ComponentIndex::Missing, std::memory_order_release);
+                }
+            }
+        }
+        gridVersion.fetch_add(1, std::memory_order_release);
+    }
+
+    // Соседи новой стены (open) были в одной компоненте. Разложить их по
+    // компонентам после её появления; false - не уложились в бюджет.
+    // Волна пускается от каждого соседа по очереди: от соседа в большой части
+    // она упирается в бюджет, а от отрезанного кармана - исчерпывает его.
+    bool splitComponent(std::vector<int> open) {
+        SearchWorkspace& ws = threadWorkspace();
+        int offsets[4];
+        neighborOffsets(offsets);
+        size_t budget = std::max(MIN_SPLIT_BUDGET, cellCount() / 64);
+
+        size_t i = 0;
+        while (open.size() > 1 && i < open.size()) {
+            ws.begin(cellCount());
+            int head = 0, tail = 0;
+            ws.stamp[open[i]] = ws.epoch;
+            ws.queue[tail++] = open[i];
+            size_t reached = 1;
+            while (head < tail && reached < open.size() && static_cast<size_t>(tail) < budget) {
+                int k = ws.queue[head++];
+                for (int d = 0; d < 4; d++) {
+                    int nkey = k + offsets[d];
+                    if (isWall(nkey) || ws.visited(nkey)) continue;
+                    ws.stamp[nkey] = ws.epoch;
+                    ws.queue[tail++] = nkey;
+                    reached += std::count(open.begin(), open.end(), nkey);
+                }
+            }
+            if (reached == open.size()) return true;
+            if (head < tail) {
+                i++; // бюджет кончился - пробуем следующего соседа
+                continue;
+            }
+
+            // Волна исчерпала свою область, не встретив остальных соседей
+            int label = componentParent.size();
+            componentParent.push_back(label);
+            componentRank.push_back(0);
+            components++;
+            for (int c = 0; c < tail; c++) {
+                componentLabel[ws.queue[c]] = label;
+            }
+            std::erase_if(open, [&](int k) { return ws.visited(k); });
+            i = 0;
+        }
+        return open.size() <= 1;
+    }
+
+    // Корень метки без сжатия путей: запросы константны и могут идти параллельно,
+    // а объединение по рангу держит глубину в O(log n)
+    int findComponent(int label) const {
+        while (componentParent[label] != label) {
+            label = componentParent[label];
+        }
+        return label;
+    }
+
+    int uniteComponents(int a, int b) {
+        if (a == b) return a;
+        if (componentRank[a] < componentRank[b]) std::swap(a, b);
+        componentParent[b] = a;
+        if (componentRank[a] == componentRank[b]) componentRank[a]++;
+        components--;
+        return a;
+    }
+
+    // Разметка компонент за один проход: объединяем каждую клетку с соседями
+    // слева и сверху, корнем всегда делая меньший ключ. Тогда parent[k] <= k,
+    // и второй проход по возрастанию ключей сразу выдаёт плотные номера.
+    void buildComponents() const {
+        std::vector<int>& label = componentLabel;
+        label.assign(cellCount(), -1);
+
+        auto find = [&](int k) {
+            while (label[k] != k) {
+                label[k] = label[label[k]];
+                k = label[k];
+            }
+            return k;
+        };
+        auto unite = [&](int a, int b) {
+            a = find(a);
+            b = find(b);
+            if (a < b) std::swap(a, b);
+            label[a] = b;
+        };
+
+        for (int x = 0; x < rows; x++) {
+            int key = coordToKey(x, 0);
+            for (int y = 0; y < cols; y++, key++) {
+                if (isWall(key)) continue;
+                label[key] = key;
+                if (!isWall(key - 1)) unite(key, key - 1);
+                if (!isWall(key - stride)) unite(key, key - stride);
+            }
+        }
+
+        components = 0;
+        for (int x = 0; x < rows; x++) {
+            int key = coordToKey(x, 0);
+            for (int y = 0; y < cols; y++, key++) {
+                if (label[key] == -1) continue;
+                // Корень - сам себе родитель; у остальных родитель уже перенумерован
+                label[key] = label[key] == key ? static_cast<int>(components++) : label[label[key]];
+            }
+        }
+        componentParent.resize(components);
+        std::iota(componentParent.begin(), componentParent.end(), 0);
+        componentRank.assign(components, 0);
+    }
+
+    void ensureComponents() const {
+        if (componentState.load(std::memory_order_acquire) == ComponentIndex::Valid) return;
+        std::lock_guard<std::mutex> guard(componentLock);
+        if (componentState.load(std::memory_order_relaxed) != ComponentIndex::Valid) {
+            buildComponents();
+            componentState.store(ComponentIndex::Valid, std::memory_order_release);
+        }
+    }
+
+    // Предпроверка поисков: true, если путь заведомо невозможен. Сброшенный
+    // индекс перестраивается здесь же: это один проход по сетке на серию правок,
+    // не дороже одного поиска, который без предпроверки обошёл бы компоненту.
+    bool knownDisconnected(std::pair<int, int> a, std::pair<int, int> b) const {
+        return !sameComponent(a, b);
+    }
+
+    // Выделить буфер r x c: все клетки - проходы, рамка - стены
+    void allocate(int r, int c) {
+        rows = r;
+        cols = c;
+        stride = ((c + 2 + 63) / 64) * 64;
+        int rowWords = stride / 64;
+        unmap();
+        costs.clear();
+        maxCost = 1;
+        walls.assign(wordCount(), ~uint64_t(0));
+        wallBits = walls.data();
+        for (int x = 1; x <= rows; x++) {
+            uint64_t* row = &wallBits[static_cast<size_t>(x) * rowWords];
+            for (int w = 0; w < rowWords; w++) {
+                // Внутренние клетки строки занимают биты [1, cols]
+                int lo = std::max(w * 64, 1);
+                int hi = std::min(w * 64 + 64, cols + 1);
+                for (int b = lo; b < hi; b++) {
+                    row[w] &= ~(uint64_t(1) << (b - w * 64));
+                }
+            }
+        }
+        visitedCount = 0;
+        expandedCount = 0;
+        gridChanged();
+    }
+
+    void loadGrid(const std::vector<std::vector<int>>& maze) {
+        allocate(maze.size(), maze.empty() ? 0 : maze[0].size());
+        for (int x = 0; x < rows; x++) {
+            for (int y = 0; y < cols; y++) {
+                int value = y < static_cast<int>(maze[x].size()) ? maze[x][y] : 1;
+                if (value != 0) {
+                    setWall(coordToKey(x, y), true);
+                }
+            }
+        }
+    }
+
+    bool isValid(int x, int y) const {
+        return x >= 0 && x < rows && y >= 0 && y < cols;
+    }
+
+    bool isPassable(int x, int y) const {
+        return isValid(x, y) && !isWall(coordToKey(x, y));
+    }
+
+    void publishStats(size_t visited, size_t expanded) const {
+        visitedCount.store(visited, std::memory_order_relaxed);
+        expandedCount.store(expanded, std::memory_order_relaxed);
+    }
+
+    std::vector<std::pair<int, int>> buildPath(const SearchWorkspace& ws, int endKey) const {
+        std::vector<std::pair<int, int>> path;
+        for (int k = endKey; k != -1; k = ws.parent[k]) {
+            path.push_back(keyToCoord(k));
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Получить количество соседей-проходов
+    int countPassageNeighbors(int key) const {
+        return !isWall(key - stride) + !isWall(key + 1) +
+               !isWall(key + stride) + !isWall(key - 1);
+    }
+
+    // Тупики среди 64 клеток слова буфера: проход, у которого ровно один сосед-проход.
+    // Соседи слева/справа - сдвиги слова с переносом бита из соседнего слова.
+    void neighborMasks(int word, uint64_t& pass, uint64_t& up, uint64_t& down,
+                       uint64_t& left, uint64_t& right) const {
+        int rowWords = stride / 64;
+        pass = ~wallBits[word];
+        up = ~wallBits[word - rowWords];
+        down = ~wallBits[word + rowWords];
+        left = (pass << 1) | (~wallBits[word - 1] >> 63);
+        right = (pass >> 1) | (~wallBits[word + 1] << 63);
+    }
+
+    uint64_t deadEndMask(int word) const {
+        uint64_t pass, up, down, left, right;
+        neighborMasks(word, pass, up, down, left, right);
+        uint64_t any = up | down | left | right;
+        uint64_t two = (up & down) | ((up | down) & (left | right)) | (left & right);
+        return pass & any & ~two;
+    }
+
+    // Статистика по словам [firstWord, lastWord): число соседей считается
+    // сразу для 64 клеток побитовым сумматором (три разряда суммы 0..4)
+    void accumulateStats(int firstWord, int lastWord, MazeStats& out) const {
+        for (int w = firstWord; w < lastWord; w++) {
+            uint64_t pass, up, down, left, right;
+            neighborMasks(w, pass, up, down, left, right);
+            if (!pass) continue;
+
+            uint64_t vertical = up ^ down, verticalCarry = up & down;
+            uint64_t horizontal = left ^ right, horizontalCarry = left & right;
+            uint64_t bit0 = vertical ^ horizontal;
+            uint64_t carry = vertical & horizontal;
+            uint64_t bit1 = verticalCarry ^ horizontalCarry ^ carry;
+            uint64_t bit2 = verticalCarry & horizontalCarry; // все четыре соседа
+
+            out.passable += std::popcount(pass);
+            out.degrees[0] += std::popcount(pass & ~(bit0 | bit1 | bit2));
+            out.degrees[1] += std::popcount(pass & bit0 & ~bit1);
+            out.degrees[2] += std::popcount(pass & ~bit0 & bit1);
+            out.degrees[3] += std::popcount(pass & bit0 & bit1);
+            out.degrees[4] += std::popcount(pass & bit2);
+        }
+    }
+
+    // Строк в одной плитке параллельного подсчета статистики
+    static constexpr int STATS_TILE_ROWS = 256;
+
+    // Компоненты плитки для сшивки с соседними: отрезки проходов первой и
+    // последней строки плитки и номера их компонент внутри плитки (0..classes)
+    struct TileComponents {
+        std::vector<std::pair<int, int>> firstRuns, lastRuns;
+        std::vector<int> firstClass, lastClass;
+        int classes = 0;
+    };
+
+    // Отрезки проходов строки буфера row: пары [начало, конец) в битах строки.
+    // Рамка - стены, поэтому отрезок всегда заканчивается внутри строки.
+    void rowRuns(int row, std::vector<std::pair<int, int>>& runs) const {
+        int rowWords = stride / 64;
+        const uint64_t* bits = wallBits + static_cast<size_t>(row) * rowWords;
+        // Первый бит со значением wall, начиная с pos; stride, если такого нет
+        auto next = [&](int pos, bool wall) {
+            int w = pos >> 6;
+            uint64_t word = (wall ? bits[w] : ~bits[w]) & (~uint64_t(0) << (pos & 63));
+            while (!word) {
+                if (++w == rowWords) return stride;
+                word = wall ? bits[w] : ~bits[w];
+            }
+            return w * 64 + std::countr_zero(word);
+        };
+        runs.clear();
+        for (int pos = next(0, false); pos < stride; pos = next(pos, false)) {
+            int end = next(pos, true);
+            runs.push_back({pos, end});
+            pos = end;
+        }
+    }
+
+    // Вызвать f(i, j) для каждой пары перекрывающихся по столбцам отрезков
+    // a[i] и b[j] (оба списка упорядочены) - такие отрезки соседних строк связаны
+    template <typename F>
+    static void forEachOverlap(const std::vector<std::pair<int, int>>& a,
+                               const std::vector<std::pair<int, int>>& b, F&& f) {
+        size_t i = 0, j = 0;
+        while (i < a.size() && j < b.size()) {
+            if (a[i].first < b[j].second && b[j].first < a[i].second) f(i, j);
+            if (a[i].second < b[j].second) i++;
+            else j++;
+        }
+    }
+
+    // Компоненты строк буфера [firstRow, lastRow) без учёта соседних плиток:
+    // union-find по отрезкам проходов. Отрезок наследует компоненту первого
+    // перекрывающего его по столбцам отрезка строки выше; остальные
+    // перекрывающие сливаются с ней. Ответ - число компонент в out.components.
+    void accumulateComponents(int firstRow, int lastRow, MazeStats& out,
+                              TileComponents& border) const {
+        std::vector<int> parent;
+        auto find = [&](int k) {
+            while (parent[k] != k) {
+                parent[k] = parent[parent[k]];
+                k = parent[k];
+            }
+            return k;
+        };
+
+        std::vector<std::pair<int, int>> previous, current;
+        std::vector<int> previousIds, currentIds, firstIds;
+        size_t unions = 0;
+        for (int row = firstRow; row < lastRow; row++) {
+            rowRuns(row, current);
+            currentIds.resize(current.size());
+            size_t i = 0;
+            for (size_t j = 0; j < current.size(); j++) {
+                auto [begin, end] = current[j];
+                while (i < previous.size() && previous[i].second <= begin) i++;
+                int id = -1;
+                // Отрезки выше, пересекающие [begin, end); последний может
+                // задеть и следующий отрезок, поэтому i на нём не сдвигается
+                for (size_t k = i; k < previous.size() && previous[k].first < end; k++) {
+                    int root = find(previousIds[k]);
+                    if (id == -1) {
+                        id = root;
+                    } else if (root != id) {
+                        parent[std::max(root, id)] = std::min(root, id);
+                        id = std::min(root, id);
+                        unions++;
+                    }
+                }
+                if (id == -1) {
+                    id = parent.size();
+                    parent.push_back(id);
+                }
+                currentIds[j] = id;
+            }
+            if (row == firstRow) {
+                border.firstRuns = current;
+                firstIds = currentIds;
+            }
+            std::swap(previous, current);
+            std::swap(previousIds, currentIds);
+        }
+        border.lastRuns = previous;
+        out.components = parent.size() - unions;
+
+        // Плотные номера компонент только для отрезков на краях плитки
+        std::unordered_map<int, int> classOf;
+        auto classify = [&](const std::vector<int>& ids, std::vector<int>& classes) {
+            classes.clear();
+            for (int id : ids) {
+                auto [it, added] = classOf.try_emplace(find(id), border.classes);
+                if (added) border.classes++;
+                classes.push_back(it->second);
+            }
+        };
+        classify(firstIds, border.firstClass);
+        classify(previousIds, border.lastClass);
+    }
+
+    // Сложить плитки и сшить компоненты по их границам: отрезки последней
+    // строки плитки и первой строки следующей, перекрывающиеся по столбцам,
+    // объединяют компоненты. Сшивка последовательна, но идёт только по краям.
+    MazeStats finishStats(const std::vector<MazeStats>& tiles,
+                          const std::vector<TileComponents>& borders) const {
+        MazeStats stats;
+        stats.rows = rows;
+        stats.cols = cols;
+        for (const MazeStats& tile : tiles) {
+            stats.passable += tile.passable;
+            stats.components += tile.components;
+            for (int k = 0; k < 5; k++) {
+                stats.degrees[k] += tile.degrees[k];
+            }
+        }
+        stats.deadEnds = stats.degrees[1];
+
+        std::vector<int> offset(borders.size() + 1, 0);
+        for (size_t t = 0; t < borders.size(); t++) {
+            offset[t + 1] = offset[t] + borders[t].classes;
+        }
+        std::vector<int> parent(offset.back());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&](int k) {
+            while (parent[k] != k) {
+                parent[k] = parent[parent[k]];
+                k = parent[k];
+            }
+            return k;
+        };
+        for (size_t t = 0; t + 1 < borders.size(); t++) {
+            const TileComponents& upper = borders[t];
+            const TileComponents& lower = borders[t + 1];
+            forEachOverlap(upper.lastRuns, lower.firstRuns, [&](size_t i, size_t j) {
+                int a = find(offset[t] + upper.lastClass[i]);
+                int b = find(offset[t + 1] + lower.firstClass[j]);
+                if (a != b) {
+                    parent[std::max(a, b)] = std::min(a, b);
+                    stats.components--;
+                }
+            });
+        }
+        return stats;
+    }
+
+    // Проверка, является ли клетка тупиком
+    bool isDeadEnd(int key) const {
+        if (isWall(key)) return false; // Стена не может быть тупиком
+
+        // Тупик имеет только 1 проход
+        return countPassageNeighbors(key) == 1;
+    }
+
+public:
+    Maze() {
+        allocate(0, 0);
+    }
+    Maze(const std::vector<std::vector<int>>& maze) {
+        loadGrid(maze);
+    }
+    Maze(int r, int c) {
+        allocate(r, c);
+    }
+    // Копия всегда получает собственный буфер, даже если исходник отображён из файла
+    Maze(const Maze& other)
+        : walls(other.wallBits, other.wallBits + other.wordCount()),
+          costs(other.costs), costCounts(other.costCounts), maxCost(other.maxCost),
+          rows(other.rows), cols(other.cols), stride(other.stride) {
+        wallBits = walls.data();
+    }
+    Maze& operator=(const Maze& other) {
+        if (this != &other) {
+            std::vector<uint64_t> copy(other.wallBits, other.wallBits + other.wordCount());
+            unmap();
+            walls = std::move(copy);
+            wallBits = walls.data();
+            costs = other.costs;
+            costCounts = other.costCounts;
+            maxCost = other.maxCost;
+            rows = other.rows;
+            cols = other.cols;
+            stride = other.stride;
+            publishStats(0, 0);
+            gridChanged();
+        }
+        return *this;
+    }
+    ~Maze() {
+        unmap();
+    }
+
+    void setGrid(const std::vector<std::vector<int>>& maze) {
+        loadGrid(maze);
+    }
+
+    // Рамка из стен на месте: верхняя и нижняя строки - сплошные стены, в каждой
+    // строке стоят бит 0 и все биты начиная с cols + 1 (правая стена и добивка до stride)
+    static bool frameIntact(const uint64_t* bits, int r, int c, int s) {
+        int rowWords = s / 64;
+        int lastWord = (c + 1) / 64;
+        uint64_t rightMask = ~uint64_t(0) << ((c + 1) % 64);
+        for (int x = 0; x < r + 2; x++) {
+            const uint64_t* row = bits + static_cast<size_t>(x) * rowWords;
+            if (x == 0 || x == r + 1) {
+                for (int w = 0; w < rowWords; w++) {
+                    if (row[w] != ~uint64_t(0)) return false;
+                }
+                continue;
+            }
+            if (!(row[0] & 1) || (row[lastWord] & rightMask) != rightMask) return false;
+            for (int w = lastWord + 1; w < rowWords; w++) {
+                if (row[w] != ~uint64_t(0)) return false;
+            }
+        }
+        return true;
+    }
+
+    // Сохранить лабиринт в бинарный файл: заголовок и слова сетки как есть,
+    // а если заданы стоимости - за ними слой стоимостей
+    bool save(const std::string& path) const {
+        FileHeader header{};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+        header.version = FILE_VERSION;
+        header.headerSize = sizeof(FileHeader);
+        header.rows = rows;
+        header.cols = cols;
+        header.stride = stride;
+        header.flags = costs.empty() ? 0 : FILE_COSTS;
+        header.wordCount = wordCount();
+
+        // Пишем во временный файл рядом и переименовываем поверх цели: path может
+        // быть источником loadMapped, и усечение испортило бы отображённые слова
+        std::string temp = path + ".tmp";
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(wallBits), header.wordCount * sizeof(uint64_t));
+        if (!costs.empty()) {
+            out.write(reinterpret_cast<const char*>(costs.data()), costs.size());
+        }
+        out.close();
+        if (!out || std::rename(temp.c_str(), path.c_str()) != 0) {
+            std::remove(temp.c_str());
+            std::cout << "Cannot write maze file: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Открыть файл, записанный save, без копирования: слова сетки отображаются
+    // в память (mmap), и поиски читают их прямо оттуда. Страницы подгружаются
+    // по мере обращения, поэтому время загрузки не зависит от размера лабиринта.
+    // Слой стоимостей (если он есть) копируется в память - он нужен целиком.
+    // Отображение MAP_PRIVATE: setCell и braidMaze меняют только копию в памяти.
+    // Ключи клеток - int, поэтому сетки больше INT_MAX клеток с рамкой отвергаются.
+    // Поиски полагаются на рамку из стен, поэтому она проверяется: верхняя и нижняя
+    // строки целиком и края каждой строки - это читает O(rows) страниц, а не весь файл.
+    bool loadMapped(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cout << "Cannot open maze file: " << path << std::endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+            close(fd);
+            std::cout << "Invalid maze file: " << path << std::endl;
+            return false;
+        }
+        size_t length = info.st_size;
+        void* address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            std::cout << "Cannot map maze file: " << path << std::endl;
+            return false;
+        }
+
+        FileHeader header;
+        std::memcpy(&header, address, sizeof(header));
+        // Размеры считаются в 64 битах: rows + 2 и cols + 2 не должны переполниться
+        uint64_t cells = static_cast<uint64_t>(int64_t(header.rows) + 2) * uint64_t(header.stride);
+        bool valid = std::memcmp(header.magic, FILE_MAGIC, sizeof(header.magic)) == 0 &&
+                     header.version == FILE_VERSION &&
+                     header.headerSize >= sizeof(FileHeader) && header.headerSize % 8 == 0 &&
+                     header.rows >= 0 && header.cols >= 0 &&
+                     header.stride % 64 == 0 && int64_t(header.stride) >= int64_t(header.cols) + 2 &&
+                     cells <= static_cast<uint64_t>(std::numeric_limits<int>::max()) &&
+                     header.wordCount == cells / 64 && (header.flags & ~FILE_COSTS) == 0 &&
+                     header.headerSize + header.wordCount * sizeof(uint64_t) +
+                         (header.flags & FILE_COSTS ? cells : 0) <= length;
+        if (valid) {
+            const uint64_t* bits = reinterpret_cast<const uint64_t*>(
+                static_cast<const char*>(address) + header.headerSize);
+            valid = frameIntact(bits, header.rows, header.cols, header.stride);
+        }
+        if (!valid) {
+            munmap(address, length);
+            std::cout << "Invalid maze file: " << path << std::endl;
+            return false;
+        }
+
+        unmap();
+        walls.clear();
+        walls.shrink_to_fit();
+        costs.clear();
+        maxCost = 1;
+        if (header.flags & FILE_COSTS) {
+            const uint8_t* layer = static_cast<const uint8_t*>(address) + header.headerSize +
+                                   header.wordCount * sizeof(uint64_t);
+            costs.assign(layer, layer + cells);
+            recountCosts();
+        }
+        mappedAddress = address;
+        mappedLength = length;
+        wallBits = reinterpret_cast<uint64_t*>(static_cast<char*>(address) + header.headerSize);
+        rows = header.rows;
+        cols = header.cols;
+        stride = header.stride;
+        publishStats(0, 0);
+        gridChanged();
+        return true;
+    }
+
+    // value != 0 - стена, 0 - проход, как в исходной сетке int.
+    // Стоимость клетки при этом не меняется (см. setCost).
+    void setCell(int x, int y, int value) {
+        if (!isValid(x, y)) return;
+        int key = coordToKey(x, y);
+        if (isWall(key) == (value != 0)) return;
+        setWall(key, value != 0);
+        cellChanged(key);
+    }
+
+    // Задать стоимость входа в клетку: 0 - стена, иначе проход со стоимостью
+    // cost (значения больше MAX_COST обрезаются). Внимание: здесь 0 означает
+    // стену, а в setCell и setGrid - проход. Нулевой стоимости прохода не бывает,
+    // поэтому в сетке стоимостей 0 свободен под стену, как и в cellCost.
+    // Стена сохраняет прежнюю стоимость и вернёт её, если setCell снова её откроет.
+    void setCost(int x, int y, int cost) {
+        if (!isValid(x, y)) return;
+        int key = coordToKey(x, y);
+        bool wasWall = isWall(key);
+        if (cost <= 0) {
+            setWall(key, true);
+        } else {
+            if (costs.empty()) {
+                costs.assign(cellCount(), 1);
+                recountCosts();
+            }
+            assignCost(key, std::min(cost, MAX_COST));
+            setWall(key, false);
+        }
+        if (isWall(key) != wasWall) {
+            cellChanged(key);
+        } else {
+            gridVersion.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    // Загрузить сетку стоимостей rows x cols: 0 - стена, положительное - стоимость
+    // (соглашение setCost, обратное setGrid). maxCost считается заново по сетке.
+    void setCostGrid(const std::vector<std::vector<int>>& grid) {
+        allocate(grid.size(), grid.empty() ? 0 : grid[0].size());
+        costs.assign(cellCount(), 1);
+        for (int x = 0; x < rows; x++) {
+            for (int y = 0; y < cols; y++) {
+                int cost = y < static_cast<int>(grid[x].size()) ? grid[x][y] : 0;
+                int key = coordToKey(x, y);
+                if (cost <= 0) {
+                    setWall(key, true);
+                } else {
+                    costs[key] = std::min(cost, MAX_COST);
+                }
+            }
+        }
+        recountCosts();
+        gridChanged();
+    }
+
+    // Стоимость входа в клетку; 0 для стен и клеток вне сетки
+    int cellCost(int x, int y) const {
+        if (!isPassable(x, y)) return 0;
+        return costs.empty() ? 1 : costs[coordToKey(x, y)];
+    }
+
+    // Лежат ли обе клетки в одной компоненте связности - O(1) после построения индекса
+    bool sameComponent(std::pair<int, int> a, std::pair<int, int> b) const {
+        if (!isPassable(a.first, a.second) || !isPassable(b.first, b.second)) {
+            return false;
+        }
+        ensureComponents();
+        return findComponent(componentLabel[coordToKey(a.first, a.second)]) ==
+               findComponent(componentLabel[coordToKey(b.first, b.second)]);
+    }
+
+    size_t componentCount() const {
+        ensureComponents();
+        return components;
+    }
+
+    // BRAIDING ALGORITHM - устранение тупиков
+    // braidFactor - вероятность "зашить" каждый тупик, а не доля тупиков, как
+    // раньше: зашивается в среднем braidFactor от числа тупиков, но на маленьком
+    // лабиринте их может оказаться заметно больше или меньше. Тупики, возникшие
+    // по ходу (у открытой стены и её соседей), тоже разыгрываются.
+    // Стены только убираются, поэтому клетка бывает тупиком не дольше одного
+    // отрезка времени: сетка проходится один раз, тупики позади текущей позиции
+    // разбираются сразу из небольшого списка. Итого O(клеток), время - bench_braid.cpp.
+    // Результат определяется seed; verbose = false отключает построчный вывод.
+    void braidMaze(double braidFactor = 0.5, uint64_t seed = 42, bool verbose = true) {
+        if (verbose) {
+            std::cout << "\n=== APPLYING BRAIDING ALGORITHM ===" << std::endl;
+            std::cout << "Braid factor: " << braidFactor << std::endl;
+        }
+
+        std::mt19937_64 rng(seed);
+        double chance = std::clamp(braidFactor, 0.0, 1.0);
+        // Сравнение с порогом вместо bernoulli_distribution - без арифметики double на каждый тупик
+        uint64_t threshold = chance >= 1.0 ? std::numeric_limits<uint64_t>::max()
+                                           : static_cast<uint64_t>(std::ldexp(chance, 64));
+
+        int offsets[4];
+        neighborOffsets(offsets);
+        int rowWords = stride / 64;
+
+        // Число тупиков до брайдинга, как и раньше - до построчного вывода
+        if (verbose) {
+            size_t found = 0;
+            for (int w = rowWords; w < (rows + 1) * rowWords; w++) {
+                found += std::popcount(deadEndMask(w));
+            }
+            std::cout << "Found " << found << " dead ends" << std::endl;
+        }
+
+        size_t braidCount = 0;
+        std::vector<int> behind;
+        int scanKey = 0;
+
+        auto visit = [&](int key) {
+            if (rng() >= threshold && chance < 1.0) return;
+            int opened = braidDeadEnd(key, verbose);
+            if (opened == -1) return;
+            braidCount++;
+
+            // Открытая клетка и её соседи могли стать тупиками;
+            // те, что впереди, встретятся при обходе сами
+            if (opened < scanKey && isDeadEnd(opened)) behind.push_back(opened);
+            for (int d = 0; d < 4; d++) {
+                int nkey = opened + offsets[d];
+                if (nkey < scanKey && isDeadEnd(nkey)) behind.push_back(nkey);
+            }
+        };
+
+        for (int w = rowWords; w < (rows + 1) * rowWords; w++) {
+            uint64_t mask = deadEndMask(w);
+            while (mask) {
+                int bit = std::countr_zero(mask);
+                scanKey = w * 64 + bit;
+                size_t before = braidCount;
+                visit(scanKey);
+                while (!behind.empty()) {
+                    int key = behind.back();
+                    behind.pop_back();
+                    if (isDeadEnd(key)) visit(key);
+                }
+                mask &= mask - 1;
+                // Стены изменились - пересчитываем остаток слова
+                if (braidCount != before && mask) {
+                    mask = deadEndMask(w) & (~uint64_t(0) << (bit + 1));
+                }
+            }
+        }
+        gridChanged();
+
+        if (verbose) {
+            std::cout << "Braided " << braidCount << " dead ends" << std::endl;
+        }
+    }
+
+private:
+    // "Зашивание" конкретного тупика; возвращает ключ убранной стены или -1
+    int braidDeadEnd(int key, bool verbose) {
+        const int dx[4] = {-1, 0, 1, 0};
+        const int dy[4] = {0, 1, 0, -1};
+        int offsets[4];
+        neighborOffsets(offsets);
+        auto [x, y] = keyToCoord(key);
+
+        // Находим стену, которую можно убрать чтобы соединить с другим проходом
+        for (int i = 0; i < 4; i++) {
+            int nx = x + dx[i];
+            int ny = y + dy[i];
+            int nkey = key + offsets[i];
+
+            // Рамку не трогаем - это не стена лабиринта
+            if (isValid(nx, ny) && isWall(nkey)) {
+                // Проверяем, не создаст ли это слишком много соединений
+                int newConnections = countPassageNeighbors(nkey);
+
+                // Если убирание стены создает разумное количество соединений
+                if (newConnections >= 1 && newConnections <= 2) {
+                    setWall(nkey, false); // Убираем стену
+                    if (verbose) {
+                        std::cout << "  Braided: (" << x << "," << y << ") -> (" << nx << "," << ny << ")" << std::endl;
+                    }
+                    return nkey;
+                }
+            }
+        }
+        return -1;
+    }
+
+public:
+    // Wave Algorithm (Branding Algorithm)
+    std::vector<std::pair<int, int>> findPathWave(std::pair<int, int> start,
+                                                 std::pair<int, int> end) const {
+        if (!isPassable(start.first, start.second) ||
+            !isPassable(end.first, end.second)) {
+            std::cout << "Start or end position is blocked!" << std::endl;
+            return {};
+        }
+
+        // Разные компоненты - пути нет, волну не запускаем
+        if (knownDisconnected(start, end)) {
+            publishStats(0, 0);
+            std::cout << "No path found by wave algorithm!" << std::endl;
+            return {};
+        }
+
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+        ws.dist.resize(cellCount());
+
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        int startKey = coordToKey(start.first, start.second);
+        int endKey = coordToKey(end.first, end.second);
+        int head = 0, tail = 0;
+        ws.dist[startKey] = 0;
+        ws.parent[startKey] = -1;
+        ws.stamp[startKey] = ws.epoch;
+        ws.queue[tail++] = startKey;
+
+        bool found = false;
+
+        while (head < tail) {
+            int key = ws.queue[head++];
+
+            if (key == endKey) {
+                found = true;
+                break;
+            }
+
+            for (int i = 0; i < 4; i++) {
+                int nkey = key + offsets[i];
+
+                if (!isWall(nkey) && !ws.visited(nkey)) {
+                    ws.dist[nkey] = ws.dist[key] + 1;
+                    ws.parent[nkey] = key;
+                    ws.stamp[nkey] = ws.epoch;
+                    ws.queue[tail++] = nkey;
+                }
+            }
+        }
+        publishStats(tail, head);
+
+        if (!found) {
+            std::cout << "No path found by wave algorithm!" << std::endl;
+            return {};
+        }
+
+        std::vector<std::pair<int, int>> path = buildPath(ws, endKey);
+
+        std::cout << "Wave algorithm path found! Length: " << path.size() << std::endl;
+        return path;
+    }
+
+    // BFS Algorithm
+    std::vector<std::pair<int, int>> findPathBFS(std::pair<int, int> start,
+                                                std::pair<int, int> end) const {
+        if (!isPassable(start.first, start.second) ||
+            !isPassable(end.first, end.second)) {
+            return {};
+        }
+
+        if (knownDisconnected(start, end)) {
+            publishStats(0, 0);
+            std::cout << "No BFS path found!" << std::endl;
+            return {};
+        }
+
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+
+        // В очереди только ключи клеток, путь восстанавливается по ws.parent
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        int startKey = coordToKey(start.first, start.second);
+        int endKey = coordToKey(end.first, end.second);
+        int head = 0, tail = 0;
+        ws.queue[tail++] = startKey;
+        ws.stamp[startKey] = ws.epoch;
+        ws.parent[startKey] = -1;
+
+        while (head < tail) {
+            int key = ws.queue[head++];
+
+            if (key == endKey) {
+                publishStats(tail, head);
+                std::vector<std::pair<int, int>> path = buildPath(ws, endKey);
+                std::cout << "BFS path found! Length: " << path.size() << std::endl;
+                return path;
+            }
+
+            for (int i = 0; i < 4; i++) {
+                int nkey = key + offsets[i];
+
+                if (!isWall(nkey) && !ws.visited(nkey)) {
+                    ws.stamp[nkey] = ws.epoch;
+                    ws.parent[nkey] = key;
+                    ws.queue[tail++] = nkey;
+                }
+            }
+        }
+        publishStats(tail, head);
+
+        std::cout << "No BFS path found!" << std::endl;
+        return {};
+    }
+
+    // A* Algorithm - манхэттенская эвристика, двоичная куча
+    std::vector<std::pair<int, int>> findPathAStar(std::pair<int, int> start,
+                                                  std::pair<int, int> end) const {
+        if (!isPassable(start.first, start.second) ||
+            !isPassable(end.first, end.second)) {
+            return {};
+        }
+
+        if (knownDisconnected(start, end)) {
+            publishStats(0, 0);
+            std::cout << "No A* path found!" << std::endl;
+            return {};
+        }
+
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+        ws.dist.resize(cellCount());
+
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        int startKey = coordToKey(start.first, start.second);
+        int endKey = coordToKey(end.first, end.second);
+
+        auto heuristic = [&](int key) {
+            auto [x, y] = keyToCoord(key);
+            return std::abs(x - end.first) + std::abs(y - end.second);
+        };
+
+        // (f, -g, key): при равном f сначала раскрываем более глубокие клетки
+        using Entry = std::tuple<int, int, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+        size_t visited = 1, expanded = 0;
+        ws.dist[startKey] = 0;
+        ws.parent[startKey] = -1;
+        ws.stamp[startKey] = ws.epoch;
+        open.push({heuristic(startKey), 0, startKey});
+
+        while (!open.empty()) {
+            auto [f, negG, key] = open.top();
+            open.pop();
+            if (-negG != ws.dist[key]) continue; // устаревшая запись
+            expanded++;
+
+            if (key == endKey) {
+                publishStats(visited, expanded);
+                std::vector<std::pair<int, int>> path = buildPath(ws, endKey);
+                std::cout << "A* path found! Length: " << path.size() << std::endl;
+                return path;
+            }
+
+            int g = ws.dist[key] + 1;
+            for (int i = 0; i < 4; i++) {
+                int nkey = key + offsets[i];
+                if (isWall(nkey)) continue;
+
+                if (!ws.visited(nkey)) {
+                    ws.stamp[nkey] = ws.epoch;
+                    visited++;
+                } else if (ws.dist[nkey] <= g) {
+                    continue;
+                }
+                ws.dist[nkey] = g;
+                ws.parent[nkey] = key;
+                open.push({g + heuristic(nkey), -g, nkey});
+            }
+        }
+        publishStats(visited, expanded);
+
+        std::cout << "No A* path found!" << std::endl;
+        return {};
+    }
+
+    // Дейкстра для малых целых стоимостей (алгоритм Дайала). Вместо кучи -
+    // кольцо из maxCost + 1 корзин: все ключи в очереди лежат в окне
+    // [d, d + maxCost], поэтому корзина d % (maxCost + 1) содержит только
+    // клетки с расстоянием d, и вставка/извлечение стоят O(1).
+    WeightedPath findPathDijkstra(std::pair<int, int> start, std::pair<int, int> end) const {
+        if (!isPassable(start.first, start.second) ||
+            !isPassable(end.first, end.second)) {
+            return {};
+        }
+
+        if (knownDisconnected(start, end)) {
+            publishStats(0, 0);
+            std::cout << "No Dijkstra path found!" << std::endl;
+            return {};
+        }
+
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+        ws.costDist.resize(cellCount());
+        size_t ring = maxCost + 1;
+        if (ws.buckets.size() != ring) ws.buckets.assign(ring, {});
+        for (auto& bucket : ws.buckets) bucket.clear();
+
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        int startKey = coordToKey(start.first, start.second);
+        int endKey = coordToKey(end.first, end.second);
+        const uint8_t* cost = costs.empty() ? nullptr : costs.data();
+
+        size_t visited = 1, expanded = 0, pending = 1;
+        ws.costDist[startKey] = 0;
+        ws.parent[startKey] = -1;
+        ws.stamp[startKey] = ws.epoch;
+        ws.buckets[0].push_back(startKey);
+
+        for (int64_t d = 0; pending > 0; d++) {
+            // Стоимости не меньше 1, поэтому соседи попадают в другие корзины
+            std::vector<int>& bucket = ws.buckets[d % ring];
+            for (int key : bucket) {
+                pending--;
+                if (ws.costDist[key] != d) continue; // устаревшая запись
+                expanded++;
+
+                if (key == endKey) {
+                    publishStats(visited, expanded);
+                    WeightedPath result{buildPath(ws, endKey), d};
+                    std::cout << "Dijkstra path found! Length: " << result.path.size()
+                              << ", cost: " << d << std::endl;
+                    return result;
+                }
+
+                for (int k = 0; k < 4; k++) {
+                    int nkey = key + offsets[k];
+                    if (isWall(nkey)) continue;
+                    int64_t nd = d + (cost ? cost[nkey] : 1);
+
+                    if (!ws.visited(nkey)) {
+                        ws.stamp[nkey] = ws.epoch;
+                        visited++;
+                    } else if (ws.costDist[nkey] <= nd) {
+                        continue;
+                    }
+                    ws.costDist[nkey] = nd;
+                    ws.parent[nkey] = key;
+                    ws.buckets[nd % ring].push_back(nkey);
+                    pending++;
+                }
+            }
+            bucket.clear();
+        }
+        publishStats(visited, expanded);
+
+        std::cout << "No Dijkstra path found!" << std::endl;
+        return {};
+    }
+
+    // Bidirectional BFS - две волны навстречу друг другу
+    std::vector<std::pair<int, int>> findPathBidirectional(std::pair<int, int> start,
+                                                          std::pair<int, int> end) const {
+        if (!isPassable(start.first, start.second) ||
+            !isPassable(end.first, end.second)) {
+            return {};
+        }
+
+        if (knownDisconnected(start, end)) {
+            publishStats(0, 0);
+            std::cout << "No bidirectional path found!" << std::endl;
+            return {};
+        }
+
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+        ws.dist.resize(cellCount());
+        ws.backStamp.resize(cellCount(), 0);
+        ws.backParent.resize(cellCount());
+        ws.backDist.resize(cellCount());
+
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        int startKey = coordToKey(start.first, start.second);
+        int endKey = coordToKey(end.first, end.second);
+
+        std::vector<int> frontF = {startKey};
+        std::vector<int> frontB = {endKey};
+        std::vector<int> next;
+
+        size_t visited = 2, expanded = 0;
+        ws.stamp[startKey] = ws.epoch;
+        ws.dist[startKey] = 0;
+        ws.parent[startKey] = -1;
+        ws.backStamp[endKey] = ws.epoch;
+        ws.backDist[endKey] = 0;
+        ws.backParent[endKey] = -1;
+
+        // Лучшая точка встречи: клетка a из прямой волны, соседняя с ней b из обратной
+        int bestLength = -1;
+        int meetF = -1, meetB = -1;
+        if (startKey == endKey) {
+            bestLength = 0;
+            meetF = meetB = startKey;
+        }
+
+        while (bestLength == -1 && !frontF.empty() && !frontB.empty()) {
+            // Раскрываем целиком уровень меньшей волны
+            bool forward = frontF.size() <= frontB.size();
+            std::vector<int>& front = forward ? frontF : frontB;
+            std::vector<uint32_t>& ownStamp = forward ? ws.stamp : ws.backStamp;
+            std::vector<uint32_t>& otherStamp = forward ? ws.backStamp : ws.stamp;
+            std::vector<int>& ownParent = forward ? ws.parent : ws.backParent;
+            std::vector<int>& ownDist = forward ? ws.dist : ws.backDist;
+            std::vector<int>& otherDist = forward ? ws.backDist : ws.dist;
+
+            next.clear();
+            for (int key : front) {
+                expanded++;
+                for (int i = 0; i < 4; i++) {
+                    int nkey = key + offsets[i];
+                    if (isWall(nkey)) continue;
+
+                    if (otherStamp[nkey] == ws.epoch) {
+                        int length = ownDist[key] + 1 + otherDist[nkey];
+                        if (bestLength == -1 || length < bestLength) {
+                            bestLength = length;
+                            meetF = forward ? key : nkey;
+                            meetB = forward ? nkey : key;
+                        }
+                    }
+                    if (ownStamp[nkey] != ws.epoch) {
+                        ownStamp[nkey] = ws.epoch;
+                        visited++;
+                        ownDist[nkey] = ownDist[key] + 1;
+                        ownParent[nkey] = key;
+                        next.push_back(nkey);
+                    }
+                }
+            }
+            front.swap(next);
+        }
+        publishStats(visited, expanded);
+
+        if (bestLength == -1) {
+            std::cout << "No bidirectional path found!" << std::endl;
+            return {};
+        }
+
+        std::vector<std::pair<int, int>> path = buildPath(ws, meetF);
+        for (int k = (meetB == meetF ? ws.backParent[meetB] : meetB); k != -1; k = ws.backParent[k]) {
+            path.push_back(keyToCoord(k));
+        }
+
+        std::cout << "Bidirectional path found! Length: " << path.size() << std::endl;
+        return path;
+    }
+
+private:
+    // Jump Point Search для 4-связной сетки.
+    // Канонический порядок: вертикальный ход можно продолжать в любую сторону,
+    // горизонтальный - только прямо, если поворот не вынужден стеной.
+    // Горизонтальный прыжок идёт по строке стен словами по 64 клетки.
+    // Возвращает ключ точки прыжка или -1, если впереди только стена.
+    int jumpHorizontal(int key, int dir, int goalKey) const {
+        int rowWords = stride / 64;
+        int rowFirst = key / stride * rowWords;
+        int rowLast = rowFirst + rowWords - 1;
+        const uint64_t* w = wallBits;
+
+        if (dir > 0) {
+            int pos = key + 1;
+            int word = pos >> 6;
+            uint64_t mask = ~uint64_t(0) << (pos & 63);
+            // Бит 63 предыдущего слова строк сверху и снизу (для клетки "позади")
+            uint64_t upCarry = word > rowFirst ? w[word - rowWords - 1] >> 63 : 1;
+            uint64_t downCarry = word > rowFirst ? w[word + rowWords - 1] >> 63 : 1;
+            while (true) {
+                uint64_t up = w[word - rowWords];
+                uint64_t down = w[word + rowWords];
+                // Вынужденный поворот: сосед сверху (снизу) свободен, а у предыдущей клетки - стена
+                uint64_t forced = (~up & ((up << 1) | upCarry)) |
+                                  (~down & ((down << 1) | downCarry));
+                uint64_t stop = (w[word] | forced) & mask;
+                if ((goalKey >> 6) == word) {
+                    stop |= (uint64_t(1) << (goalKey & 63)) & mask;
+                }
+                if (stop) {
+                    int hit = word * 64 + std::countr_zero(stop);
+                    return isWall(hit) ? -1 : hit;
+                }
+                upCarry = up >> 63;
+                downCarry = down >> 63;
+                mask = ~uint64_t(0);
+                word++;
+            }
+        }
+
+        int pos = key - 1;
+        int word = pos >> 6;
+        uint64_t mask = (pos & 63) == 63 ? ~uint64_t(0) : (uint64_t(1) << ((pos & 63) + 1)) - 1;
+        // Бит 0 следующего слова строк сверху и снизу
+        uint64_t upCarry = word < rowLast ? (w[word - rowWords + 1] & 1) << 63 : uint64_t(1) << 63;
+        uint64_t downCarry = word < rowLast ? (w[word + rowWords + 1] & 1) << 63 : uint64_t(1) << 63;
+        while (true) {
+            uint64_t up = w[word - rowWords];
+            uint64_t down = w[word + rowWords];
+            uint64_t forced = (~up & ((up >> 1) | upCarry)) |
+                              (~down & ((down >> 1) | downCarry));
+            uint64_t stop = (w[word] | forced) & mask;
+            if ((goalKey >> 6) == word) {
+                stop |= (uint64_t(1) << (goalKey & 63)) & mask;
+            }
+            if (stop) {
+                int hit = word * 64 + 63 - std::countl_zero(stop);
+                return isWall(hit) ? -1 : hit;
+            }
+            upCarry = (up & 1) << 63;
+            downCarry = (down & 1) << 63;
+            mask = ~uint64_t(0);
+            word--;
+        }
+    }
+
+    // Вертикальный прыжок: клетка - точка прыжка, если из неё есть горизонтальный прыжок
+    int jumpVertical(int key, int step, int goalKey) const {
+        for (int cur = key + step; !isWall(cur); cur += step) {
+            if (cur == goalKey ||
+                jumpHorizontal(cur, 1, goalKey) != -1 ||
+                jumpHorizontal(cur, -1, goalKey) != -1) {
+                return cur;
+            }
+        }
+        return -1;
+    }
+
+public:
+    // Jump Point Search - A* только по точкам прыжка
+    std::vector<std::pair<int, int>> findPathJPS(std::pair<int, int> start,
+                                                std::pair<int, int> end) const {
+        if (!isPassable(start.first, start.second) ||
+            !isPassable(end.first, end.second)) {
+            return {};
+        }
+
+        if (knownDisconnected(start, end)) {
+            publishStats(0, 0);
+            std::cout << "No JPS path found!" << std::endl;
+            return {};
+        }
+
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+        ws.dist.resize(cellCount());
+
+        int startKey = coordToKey(start.first, start.second);
+        int endKey = coordToKey(end.first, end.second);
+
+        auto heuristic = [&](int key) {
+            auto [x, y] = keyToCoord(key);
+            return std::abs(x - end.first) + std::abs(y - end.second);
+        };
+        auto isVerticalMove = [&](int from, int to) {
+            return from != -1 && (to - from) % stride == 0 && to / stride != from / stride;
+        };
+
+        using Entry = std::tuple<int, int, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+        size_t visited = 1, expanded = 0;
+        ws.dist[startKey] = 0;
+        ws.parent[startKey] = -1;
+        ws.stamp[startKey] = ws.epoch;
+        open.push({heuristic(startKey), 0, startKey});
+
+        while (!open.empty()) {
+            auto [f, negG, key] = open.top();
+            open.pop();
+            if (-negG != ws.dist[key]) continue; // устаревшая запись
+            expanded++;
+
+            if (key == endKey) break;
+
+            // Направления, в которые продолжаем поиск из этой точки прыжка
+            int dirs[4];
+            int dirCount = 0;
+            int parent = ws.parent[key];
+            if (parent == -1 || isVerticalMove(parent, key)) {
+                dirs[dirCount++] = 1;
+                dirs[dirCount++] = -1;
+                if (parent == -1) {
+                    dirs[dirCount++] = stride;
+                    dirs[dirCount++] = -stride;
+                } else {
+                    dirs[dirCount++] = key > parent ? stride : -stride;
+                }
+            } else {
+                int h = key > parent ? 1 : -1;
+                dirs[dirCount++] = h;
+                if (!isWall(key - stride) && isWall(key - h - stride)) dirs[dirCount++] = -stride;
+                if (!isWall(key + stride) && isWall(key - h + stride)) dirs[dirCount++] = stride;
+            }
+
+            for (int i = 0; i < dirCount; i++) {
+                int d = dirs[i];
+                int next = (d == 1 || d == -1) ? jumpHorizontal(key, d, endKey)
+                                               : jumpVertical(key, d, endKey);
+                if (next == -1) continue;
+
+                int g = ws.dist[key] + std::abs(next - key) / (d == 1 || d == -1 ? 1 : stride);
+                if (!ws.visited(next)) {
+                    ws.stamp[next] = ws.epoch;
+                    visited++;
+                } else if (ws.dist[next] < g ||
+                           (ws.dist[next] == g && (!isVerticalMove(key, next) ||
+                                                   isVerticalMove(ws.parent[next], next)))) {
+                    // При равной длине вертикальный подход раскрывает больше направлений
+                    continue;
+                }
+                ws.dist[next] = g;
+                ws.parent[next] = key;
+                open.push({g + heuristic(next), -g, next});
+            }
+        }
+        publishStats(visited, expanded);
+
+        if (!ws.visited(endKey)) {
+            std::cout << "No JPS path found!" << std::endl;
+            return {};
+        }
+
+        // Восстанавливаем путь, заполняя прямые отрезки между точками прыжка
+        std::vector<std::pair<int, int>> path;
+        for (int k = endKey; ws.parent[k] != -1; k = ws.parent[k]) {
+            int from = ws.parent[k];
+            int step = isVerticalMove(from, k) ? stride : 1;
+            if (k < from) step = -step;
+            for (int c = k; c != from; c -= step) {
+                path.push_back(keyToCoord(c));
+            }
+        }
+        path.push_back(start);
+        std::reverse(path.begin(), path.end());
+
+        std::cout << "JPS path found! Length: " << path.size() << std::endl;
+        return path;
+    }
+
+private:
+    using Query = std::pair<std::pair<int, int>, std::pair<int, int>>;
+
+    // Разбить допустимые запросы на группы с общим стартом: order[groups[g]..groups[g+1])
+    void groupQueries(const std::vector<Query>& queries,
+                      std::vector<int>& order, std::vector<size_t>& groups) const {
+        for (int i = 0; i < static_cast<int>(queries.size()); i++) {
+            const auto& [start, end] = queries[i];
+            // Пары из разных компонент сразу получают пустой путь
+            if (!knownDisconnected(start, end)) {
+                order.push_back(i);
+            }
+        }
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return queries[a].first < queries[b].first;
+        });
+        for (size_t i = 0; i < order.size(); i++) {
+            if (i == 0 || queries[order[i]].first != queries[order[i - 1]].first) {
+                groups.push_back(i);
+            }
+        }
+        groups.push_back(order.size());
+    }
+
+    // Одна волна от общего старта группы; останавливается, когда достигнуты все цели
+    void solveGroup(const std::vector<Query>& queries, const int* order, size_t count,
+                    std::vector<std::vector<std::pair<int, int>>>& result,
+                    size_t& visited, size_t& expanded) const {
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        size_t remaining = 0;
+        for (size_t i = 0; i < count; i++) {
+            const auto& end = queries[order[i]].second;
+            int endKey = coordToKey(end.first, end.second);
+            if (ws.targetStamp[endKey] != ws.epoch) {
+                ws.targetStamp[endKey] = ws.epoch;
+                remaining++;
+            }
+        }
+
+        const auto& start = queries[order[0]].first;
+        int startKey = coordToKey(start.first, start.second);
+        int head = 0, tail = 0;
+        ws.queue[tail++] = startKey;
+        ws.stamp[startKey] = ws.epoch;
+        ws.parent[startKey] = -1;
+
+        while (head < tail && remaining > 0) {
+            int key = ws.queue[head++];
+            if (ws.targetStamp[key] == ws.epoch) {
+                remaining--;
+            }
+            for (int i = 0; i < 4; i++) {
+                int nkey = key + offsets[i];
+                if (!isWall(nkey) && !ws.visited(nkey)) {
+                    ws.stamp[nkey] = ws.epoch;
+                    ws.parent[nkey] = key;
+                    ws.queue[tail++] = nkey;
+                }
+            }
+        }
+        visited += tail;
+        expanded += head;
+
+        for (size_t i = 0; i < count; i++) {
+            const auto& end = queries[order[i]].second;
+            int endKey = coordToKey(end.first, end.second);
+            if (ws.visited(endKey)) {
+                result[order[i]] = buildPath(ws, endKey);
+            }
+        }
+    }
+
+public:
+    // Пакет запросов: одно дерево BFS на каждый различный старт.
+    // Пути совпадают с findPathWave, для недостижимых пар - пустой путь.
+    std::vector<std::vector<std::pair<int, int>>> findPaths(const std::vector<Query>& queries) const {
+        std::vector<std::vector<std::pair<int, int>>> result(queries.size());
+        std::vector<int> order;
+        std::vector<size_t> groups;
+        groupQueries(queries, order, groups);
+
+        size_t visited = 0, expanded = 0;
+        for (size_t g = 0; g + 1 < groups.size(); g++) {
+            solveGroup(queries, &order[groups[g]], groups[g + 1] - groups[g],
+                       result, visited, expanded);
+        }
+        publishStats(visited, expanded);
+
+        std::cout << "Batch: " << queries.size() << " queries, "
+                  << groups.size() - 1 << " sources" << std::endl;
+        return result;
+    }
+
+    // То же, но группы запросов раздаются потокам пула; лабиринт только читается
+    std::vector<std::vector<std::pair<int, int>>> findPaths(const std::vector<Query>& queries,
+                                                            WorkStealingPool& pool) const {
+        std::vector<std::vector<std::pair<int, int>>> result(queries.size());
+        std::vector<int> order;
+        std::vector<size_t> groups;
+        groupQueries(queries, order, groups);
+
+        std::atomic<size_t> visited{0}, expanded{0};
+        pool.run(groups.size() - 1, [&](size_t g) {
+            size_t groupVisited = 0, groupExpanded = 0;
+            solveGroup(queries, &order[groups[g]], groups[g + 1] - groups[g],
+                       result, groupVisited, groupExpanded);
+            visited += groupVisited;
+            expanded += groupExpanded;
+        });
+        publishStats(visited, expanded);
+
+        std::cout << "Batch: " << queries.size() << " queries, "
+                  << groups.size() - 1 << " sources, "
+                  << pool.size() << " threads" << std::endl;
+        return result;
+    }
+
+private:
+    // Число проходимых клеток: рамка и хвосты строк - стены, поэтому считаем по всему буферу
+    size_t passableCount() const {
+        size_t count = 0;
+        for (size_t w = 0; w < wordCount(); w++) {
+            count += std::popcount(~wallBits[w]);
+        }
+        return count;
+    }
+
+    // Битовая карта клеток пути в той же раскладке, что и стены
+    std::vector<uint64_t> pathBitmap(const std::vector<std::pair<int, int>>& path) const {
+        std::vector<uint64_t> bits(wordCount(), 0);
+        for (const auto& p : path) {
+            if (isValid(p.first, p.second)) {
+                int key = coordToKey(p.first, p.second);
+                bits[key >> 6] |= uint64_t(1) << (key & 63);
+            }
+        }
+        return bits;
+    }
+
+    // Текстовый вывод части сетки: "* " - путь, "# " - стена, ". " - проход
+    void renderText(FILE* out, const uint64_t* pathBits,
+                    int x0, int y0, int height, int width) const {
+        int x1 = std::min(rows, x0 + height);
+        int y1 = std::min(cols, y0 + width);
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+
+        std::string line = "\nMaze (" + std::to_string(rows) + "x" + std::to_string(cols) + "):\n   ";
+        for (int j = y0; j < y1; j++) {
+            line += std::to_string(j);
+            line += ' ';
+        }
+        line += '\n';
+        std::fwrite(line.data(), 1, line.size(), out);
+
+        for (int i = x0; i < x1; i++) {
+            line.clear();
+            line += std::to_string(i);
+            line += "  ";
+            int key = coordToKey(i, y0);
+            for (int j = y0; j < y1; j++, key++) {
+                bool onPath = pathBits && ((pathBits[key >> 6] >> (key & 63)) & 1);
+                line += onPath ? '*' : (isWall(key) ? '#' : '.');
+                line += ' ';
+            }
+            line += '\n';
+            std::fwrite(line.data(), 1, line.size(), out);
+        }
+        std::fflush(out);
+    }
+
+    // Перевести поле расстояний из буфера с рамкой в обычный построчный массив rows x cols
+    std::vector<int> unpadDistances(const std::vector<int>& padded) const {
+        std::vector<int> result(static_cast<size_t>(rows) * cols);
+        for (int x = 0; x < rows; x++) {
+            std::copy_n(&padded[coordToKey(x, 0)], cols, &result[static_cast<size_t>(x) * cols]);
+        }
+        return result;
+    }
+
+    // Волна по уровням: фронт уровня делится между потоками пула, клетка
+    // захватывается атомарным CAS в массиве расстояний. Если фронт становится
+    // сравним с числом всех проходов (WaveSwitch), уровень строится "снизу вверх":
+    // каждая непосещённая клетка сама ищет соседа из текущего фронта.
+    // Останавливается после уровня, на котором достигнута targetKey (-1 - полная волна).
+    void parallelWave(int sourceKey, int targetKey, WorkStealingPool& pool,
+                      std::vector<int>& dist, size_t& visited, size_t& expanded,
+                      const WaveSwitch& tuning = {}) const {
+        const size_t minChunk = 4096;
+
+        dist.assign(cellCount(), -1);
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        size_t passable = passableCount();
+        std::vector<int> frontier = {sourceKey};
+        std::vector<std::vector<int>> parts;
+        dist[sourceKey] = 0;
+        visited = 1;
+        expanded = 0;
+        bool bottomUp = false;
+
+        for (int level = 0; !frontier.empty(); level++) {
+            expanded += frontier.size();
+            if (targetKey != -1 && dist[targetKey] != -1) break;
+
+            if (!bottomUp && frontier.size() * tuning.topDown > passable) {
+                bottomUp = true;
+            } else if (bottomUp && frontier.size() * tuning.bottomUp < passable) {
+                bottomUp = false;
+            }
+
+            if (!bottomUp) {
+                size_t chunks = std::min<size_t>(pool.size() * 4,
+                                                 (frontier.size() + minChunk - 1) / minChunk);
+                parts.assign(chunks, {});
+                auto expandChunk = [&](size_t c) {
+                    size_t lo = frontier.size() * c / chunks;
+                    size_t hi = frontier.size() * (c + 1) / chunks;
+                    for (size_t i = lo; i < hi; i++) {
+                        int key = frontier[i];
+                        for (int d = 0; d < 4; d++) {
+                            int nkey = key + offsets[d];
+                            if (isWall(nkey)) continue;
+                            int expected = -1;
+                            if (std::atomic_ref<int>(dist[nkey]).compare_exchange_strong(
+                                    expected, level + 1, std::memory_order_relaxed)) {
+                                parts[c].push_back(nkey);
+                            }
+                        }
+                    }
+                };
+                if (chunks == 1) {
+                    expandChunk(0);
+                } else {
+                    pool.run(chunks, expandChunk);
+                }
+            } else {
+                // Клетку пишет только поток, которому досталась её строка - CAS не нужен,
+                // но соседние строки читаются другими потоками, поэтому запись атомарная
+                size_t chunks = std::min<size_t>(pool.size() * 4, rows);
+                parts.assign(chunks, {});
+                pool.run(chunks, [&](size_t c) {
+                    int xLo = static_cast<int>(rows * c / chunks);
+                    int xHi = static_cast<int>(rows * (c + 1) / chunks);
+                    for (int x = xLo; x < xHi; x++) {
+                        int key = coordToKey(x, 0);
+                        for (int y = 0; y < cols; y++, key++) {
+                            if (isWall(key) || dist[key] != -1) continue;
+                            for (int d = 0; d < 4; d++) {
+                                int nkey = key + offsets[d];
+                                if (std::atomic_ref<int>(dist[nkey]).load(std::memory_order_relaxed) == level) {
+                                    std::atomic_ref<int>(dist[key]).store(level + 1, std::memory_order_relaxed);
+                                    parts[c].push_back(key);
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+
+            frontier.clear();
+            for (auto& part : parts) {
+                frontier.insert(frontier.end(), part.begin(), part.end());
+            }
+            visited += frontier.size();
+        }
+    }
+
+public:
+    // Полное поле расстояний волнового алгоритма от source: rows x cols построчно,
+    // -1 для стен и недостижимых клеток
+    std::vector<int> waveDistances(std::pair<int, int> source) const {
+        if (!isPassable(source.first, source.second)) {
+            return std::vector<int>(static_cast<size_t>(rows) * cols, -1);
+        }
+
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+        ws.dist.assign(cellCount(), -1);
+
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        int sourceKey = coordToKey(source.first, source.second);
+        int head = 0, tail = 0;
+        ws.dist[sourceKey] = 0;
+        ws.queue[tail++] = sourceKey;
+
+        while (head < tail) {
+            int key = ws.queue[head++];
+            for (int i = 0; i < 4; i++) {
+                int nkey = key + offsets[i];
+                if (!isWall(nkey) && ws.dist[nkey] == -1) {
+                    ws.dist[nkey] = ws.dist[key] + 1;
+                    ws.queue[tail++] = nkey;
+                }
+            }
+        }
+        publishStats(tail, head);
+        return unpadDistances(ws.dist);
+    }
+
+    // Волна сразу от нескольких источников (например, всех выходов): за один
+    // проход получаем расстояние от каждой клетки до ближайшего источника и
+    // номер этого источника. При равных расстояниях побеждает источник,
+    // волна которого пришла первой (раньше в списке при прочих равных).
+    // Непроходимые источники и повторы пропускаются.
+    DistanceField multiSourceDistances(const std::vector<std::pair<int, int>>& sources) const {
+        DistanceField field;
+        field.rows = rows;
+        field.cols = cols;
+        field.stride = stride;
+        field.sources = sources;
+        field.dist.assign(cellCount(), -1);
+        field.label.assign(cellCount(), -1);
+
+        SearchWorkspace& ws = threadWorkspace();
+        ws.begin(cellCount());
+
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        int head = 0, tail = 0;
+        for (size_t i = 0; i < sources.size(); i++) {
+            if (!isPassable(sources[i].first, sources[i].second)) continue;
+            int key = coordToKey(sources[i].first, sources[i].second);
+            if (field.dist[key] != -1) continue;
+            field.dist[key] = 0;
+            field.label[key] = i;
+            ws.queue[tail++] = key;
+        }
+
+        while (head < tail) {
+            int key = ws.queue[head++];
+            int d = field.dist[key] + 1;
+            for (int i = 0; i < 4; i++) {
+                int nkey = key + offsets[i];
+                if (!isWall(nkey) && field.dist[nkey] == -1) {
+                    field.dist[nkey] = d;
+                    field.label[nkey] = field.label[key];
+                    ws.queue[tail++] = nkey;
+                }
+            }
+        }
+        publishStats(tail, head);
+        return field;
+    }
+
+    // То же поле расстояний, построенное параллельной волной по уровням
+    std::vector<int> waveDistances(std::pair<int, int> source, WorkStealingPool& pool,
+                                   const WaveSwitch& tuning = {}) const {
+        if (!isPassable(source.first, source.second)) {
+            return std::vector<int>(static_cast<size_t>(rows) * cols, -1);
+        }
+
+        std::vector<int> dist;
+        size_t visited, expanded;
+        parallelWave(coordToKey(source.first, source.second), -1, pool, dist, visited, expanded, tuning);
+        publishStats(visited, expanded);
+        return unpadDistances(dist);
+    }
+
+    // То же поле расстояний, но фронт и посещённые клетки - биты в раскладке
+    // буфера стен; шаг волны - сдвиги и OR слов. Сравнение с waveDistances -
+    // bench_bitwave.cpp.
+    std::vector<int> waveDistancesBitParallel(std::pair<int, int> source) const {
+        if (!isPassable(source.first, source.second)) {
+            return std::vector<int>(static_cast<size_t>(rows) * cols, -1);
+        }
+
+        SearchWorkspace& ws = threadWorkspace();
+        size_t words = wordCount();
+        int rowWords = stride / 64;
+        ws.dist.assign(cellCount(), -1);
+        ws.blockedBits.assign(wallBits, wallBits + words);
+        ws.frontierBits.assign(words, 0);
+        ws.nextBits.assign(words, 0);
+        std::vector<int>& active = ws.activeWords;
+        std::vector<int>& nextActive = ws.nextActiveWords;
+        active.clear();
+
+        int sourceKey = coordToKey(source.first, source.second);
+        uint64_t sourceBit = uint64_t(1) << (sourceKey & 63);
+        ws.frontierBits[sourceKey >> 6] = sourceBit;
+        ws.blockedBits[sourceKey >> 6] |= sourceBit;
+        ws.dist[sourceKey] = 0;
+        active.push_back(sourceKey >> 6);
+
+        size_t visited = 1, expanded = 0;
+        int step = 1;
+        // Добавить в слово c следующего фронта клетки spread, ещё не занятые стенами и волной.
+        // Рамка - сплошные стены, поэтому слова за краем лабиринта ничего не получают.
+        auto push = [&](int c, uint64_t spread) {
+            uint64_t fresh = spread & ~ws.blockedBits[c];
+            if (!fresh) return;
+            if (!ws.nextBits[c]) {
+                nextActive.push_back(c);
+            }
+            ws.nextBits[c] |= fresh;
+            ws.blockedBits[c] |= fresh;
+            visited += std::popcount(fresh);
+            for (uint64_t bits = fresh; bits; bits &= bits - 1) {
+                ws.dist[c * 64 + std::countr_zero(bits)] = step;
+            }
+        };
+
+        for (; !active.empty(); step++) {
+            nextActive.clear();
+            for (int w : active) {
+                uint64_t bits = ws.frontierBits[w];
+                expanded += std::popcount(bits);
+                push(w, (bits << 1) | (bits >> 1));
+                push(w - rowWords, bits);
+                push(w + rowWords, bits);
+                // Бит 0 слова граничит с битом 63 предыдущего (и наоборот)
+                if (bits & 1) push(w - 1, uint64_t(1) << 63);
+                if (bits >> 63) push(w + 1, 1);
+            }
+
+            for (int w : active) {
+                ws.frontierBits[w] = 0;
+            }
+            ws.frontierBits.swap(ws.nextBits);
+            active.swap(nextActive);
+        }
+        publishStats(visited, expanded);
+        return unpadDistances(ws.dist);
+    }
+
+    // Путь параллельной волной: длина совпадает с findPathWave
+    std::vector<std::pair<int, int>> findPathParallel(std::pair<int, int> start,
+                                                     std::pair<int, int> end,
+                                                     WorkStealingPool& pool) const {
+        if (!isPassable(start.first, start.second) ||
+            !isPassable(end.first, end.second)) {
+            return {};
+        }
+
+        if (knownDisconnected(start, end)) {
+            publishStats(0, 0);
+            std::cout << "No parallel wave path found!" << std::endl;
+            return {};
+        }
+
+        int offsets[4];
+        neighborOffsets(offsets);
+
+        int endKey = coordToKey(end.first, end.second);
+        std::vector<int> dist;
+        size_t visited, expanded;
+        parallelWave(coordToKey(start.first, start.second), endKey, pool, dist, visited, expanded);
+        publishStats(visited, expanded);
+
+        if (dist[endKey] == -1) {
+            std::cout << "No parallel wave path found!" << std::endl;
+            return {};
+        }
+
+        // Спускаемся от финиша по убывающим номерам волны
+        std::vector<std::pair<int, int>> path;
+        for (int key = endKey; ; ) {
+            path.push_back(keyToCoord(key));
+            if (dist[key] == 0) break;
+            for (int i = 0; i < 4; i++) {
+                if (dist[key + offsets[i]] == dist[key] - 1) {
+                    key += offsets[i];
+                    break;
+                }
+            }
+        }
+        std::reverse(path.begin(), path.end());
+
+        std::cout << "Parallel wave path found! Length: " << path.size() << std::endl;
+        return path;
+    }
+
+    // Сколько клеток раскрыл последний поиск - для сравнения алгоритмов
+    size_t lastExpanded() const {
+        return expandedCount;
+    }
+
+    uint64_t version() const {
+        return gridVersion.load(std::memory_order_acquire);
+    }
+
+    // Вывести прямоугольник [x0, x0 + height) x [y0, y0 + width), обрезанный по сетке.
+    // Каждая строка собирается в переиспользуемый буфер и пишется одним fwrite.
+    void printViewport(int x0, int y0, int height, int width,
+                       const std::vector<std::pair<int, int>>& path = {}) const {
+        std::vector<uint64_t> pathBits = pathBitmap(path);
+        renderText(stdout, path.empty() ? nullptr : pathBits.data(), x0, y0, height, width);
+    }
+
+    void printMazeWithPath(const std::vector<std::pair<int, int>>& path = {}) const {
+        printViewport(0, 0, rows, cols, path);
+    }
+
+    void printMaze() const {
+        renderText(stdout, nullptr, 0, 0, rows, cols);
+    }
+
+    // Записать лабиринт в бинарный PGM (P5): стены черные, проходы белые, путь серый
+    bool writePGM(const std::string& filename,
+                  const std::vector<std::pair<int, int>>& path = {}) const {
+        std::vector<uint64_t> pathBits = pathBitmap(path);
+        FILE* out = std::fopen(filename.c_str(), "wb");
+        if (!out) {
+            std::cout << "Cannot write image: " << filename << std::endl;
+            return false;
+        }
+        std::fprintf(out, "P5\n%d %d\n255\n", cols, rows);
+        std::vector<unsigned char> line(cols);
+        for (int i = 0; i < rows; i++) {
+            int key = coordToKey(i, 0);
+            for (int j = 0; j < cols; j++, key++) {
+                bool onPath = (pathBits[key >> 6] >> (key & 63)) & 1;
+                line[j] = onPath ? 128 : (isWall(key) ? 0 : 255);
+            }
+            std::fwrite(line.data(), 1, line.size(), out);
+        }
+        return std::fclose(out) == 0;
+    }
+
+    // Записать стены в бинарный PBM (P4): один бит на клетку, 1 - стена
+    bool writePBM(const std::string& filename) const {
+        FILE* out = std::fopen(filename.c_str(), "wb");
+        if (!out) {
+            std::cout << "Cannot write image: " << filename << std::endl;
+            return false;
+        }
+        std::fprintf(out, "P4\n%d %d\n", cols, rows);
+        std::vector<unsigned char> line((cols + 7) / 8);
+        for (int i = 0; i < rows; i++) {
+            std::fill(line.begin(), line.end(), 0);
+            int key = coordToKey(i, 0);
+            for (int j = 0; j < cols; j++, key++) {
+                if (isWall(key)) line[j >> 3] |= 0x80 >> (j & 7);
+            }
+            std::fwrite(line.data(), 1, line.size(), out);
+        }
+        return std::fclose(out) == 0;
+    }
+
+    // Статистика за один проход по упакованной сетке, без вывода.
+    // Компоненты считаются в том же проходе, индекс компонент не строится.
+    MazeStats computeStats() const {
+        int rowWords = stride / 64;
+        std::vector<MazeStats> tiles(1);
+        std::vector<TileComponents> borders(1);
+        accumulateStats(rowWords, (rows + 1) * rowWords, tiles[0]);
+        accumulateComponents(1, rows + 1, tiles[0], borders[0]);
+        return finishStats(tiles, borders);
+    }
+
+    // То же, но плитки по STATS_TILE_ROWS строк раздаются потокам пула
+    MazeStats computeStats(WorkStealingPool& pool) const {
+        int rowWords = stride / 64;
+        size_t tileCount = (rows + STATS_TILE_ROWS - 1) / STATS_TILE_ROWS;
+        std::vector<MazeStats> tiles(tileCount);
+        std::vector<TileComponents> borders(tileCount);
+        pool.run(tileCount, [&](size_t tile) {
+            int firstRow = 1 + static_cast<int>(tile) * STATS_TILE_ROWS;
+            int lastRow = std::min(firstRow + STATS_TILE_ROWS, rows + 1);
+            accumulateStats(firstRow * rowWords, lastRow * rowWords, tiles[tile]);
+            accumulateComponents(firstRow, lastRow, tiles[tile], borders[tile]);
+        });
+        return finishStats(tiles, borders);
+    }
+
+    void printStats() const {
+        MazeStats stats = computeStats();
+        std::cout << "Maze size: " << rows << "x" << cols << std::endl;
+        std::cout << "Visited cells: " << visitedCount << std::endl;
+        std::cout << "Expanded cells: " << expandedCount << std::endl;
+        std::cout << "Total cells: " << rows * cols << std::endl;
+        std::cout << "Passable cells: " << stats.passable << std::endl;
+        std::cout << "Dead ends: " << stats.deadEnds << std::endl;
+        std::cout << "Degrees (0-4):";
+        for (size_t count : stats.degrees) {
+            std::cout << " " << count;
+        }
+        std::cout << std::endl;
+        std::cout << "Components: " << stats.components << std::endl;
+    }
+
+    void clear() {
+        allocate(0, 0);
+    }
+};
+
+// Кэш найденных путей перед Maze::findPathWave / findPathBFS.
+// Путь хранится сжато: стартовая клетка и по 2 бита на шаг (направление в
+// порядке вверх, вправо, вниз, влево). При превышении бюджета байтов
+// вытесняются давно не использованные пути (LRU). Кэш помнит версию сетки;
+// любое изменение лабиринта (setCell, setGrid, braidMaze, clear, ...) меняет
+// её, и все записи сбрасываются при следующем запросе.
+// Запросы можно делать из нескольких потоков; при промахе поиск идёт вне
+// блокировки. Попадания ничего не печатают.
+class PathCache {
+public:
+    enum class Algorithm { Wave, BFS };
+
+private:
+    struct Key {
+        int sx, sy, ex, ey;
+        Algorithm algorithm;
 
-        std::vector<std::pair<int, int>> path;
-        auto current = end;
+        bool operator==(const Key& other) const {
+            return sx == other.sx && sy == other.sy && ex == other.ex && ey == other.ey &&
+                   algorithm == other.algorithm;
+        }
+    };
 
-        while (current != start) {
-            path.push_back(current);
-            current = parent[current.first][current.second];
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            uint64_t h = static_cast<uint32_t>(key.sx);
+            h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(key.sy);
+            h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(key.ex);
+            h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(key.ey);
+            h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(key.algorithm);
+            return h ^ (h >> 29);
         }
-        path.push_back(start);
-        std::reverse(path.begin(), path.end());
+    };
 
-        std::cout << "Wave algorithm path found! Length: " << path.size() << std::endl;
+    struct Entry {
+        Key key;
+        bool found;
+        std::pair<int, int> start;
+        size_t steps;
+        std::vector<uint64_t> directions; // 32 шага на слово
+
+        size_t bytes() const {
+            // Грубая оценка вместе с узлами списка и хэш-таблицы
+            return sizeof(Entry) + directions.capacity() * sizeof(uint64_t) + 64;
+        }
+    };
+
+    const Maze& maze;
+    size_t budget;
+    size_t usedBytes = 0;
+    uint64_t cachedVersion;
+    std::list<Entry> lru; // в начале - недавно использованные
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    mutable std::mutex lock;
+    std::atomic<size_t> hitCount{0};
+    std::atomic<size_t> missCount{0};
+
+    static Entry encode(const Key& key, const std::vector<std::pair<int, int>>& path) {
+        Entry entry{key, !path.empty(), {-1, -1}, 0, {}};
+        if (path.empty()) return entry;
+        entry.start = path.front();
+        entry.steps = path.size() - 1;
+        entry.directions.assign((entry.steps + 31) / 32, 0);
+        for (size_t i = 0; i < entry.steps; i++) {
+            int dx = path[i + 1].first - path[i].first;
+            int dy = path[i + 1].second - path[i].second;
+            uint64_t dir = dx < 0 ? 0 : dy > 0 ? 1 : dx > 0 ? 2 : 3;
+            entry.directions[i / 32] |= dir << (2 * (i % 32));
+        }
+        return entry;
+    }
+
+    static std::vector<std::pair<int, int>> decode(const Entry& entry) {
+        if (!entry.found) return {};
+        const int dx[4] = {-1, 0, 1, 0};
+        const int dy[4] = {0, 1, 0, -1};
+        std::vector<std::pair<int, int>> path;
+        path.reserve(entry.steps + 1);
+        auto [x, y] = entry.start;
+        path.push_back({x, y});
+        for (size_t i = 0; i < entry.steps; i++) {
+            int dir = (entry.directions[i / 32] >> (2 * (i % 32))) & 3;
+            x += dx[dir];
+            y += dy[dir];
+            path.push_back({x, y});
+        }
         return path;
     }
 
-    // BFS Algorithm
-    std::vector<std::pair<int, int>> findPathBFS(std::pair<int, int> start,
-                                                std::pair<int, int> end) {
-        if (!isPassable(start.first, start.second) ||
-            !isPassable(end.first, end.second)) {
-            return {};
+    // Вызывается под блокировкой
+    void dropStale(uint64_t version) {
+        if (version != cachedVersion) {
+            lru.clear();
+            index.clear();
+            usedBytes = 0;
+            cachedVersion = version;
+        }
+    }
+
+    std::vector<std::pair<int, int>> lookup(std::pair<int, int> start, std::pair<int, int> end,
+                                            Algorithm algorithm) {
+        Key key{start.first, start.second, end.first, end.second, algorithm};
+        uint64_t version = maze.version();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            dropStale(version);
+            auto it = index.find(key);
+            if (it != index.end()) {
+                lru.splice(lru.begin(), lru, it->second);
+                hitCount++;
+                return decode(*it->second);
+            }
+        }
+        missCount++;
+
+        std::vector<std::pair<int, int>> path = algorithm == Algorithm::Wave
+                                                     ? maze.findPathWave(start, end)
+                                                     : maze.findPathBFS(start, end);
+        Entry entry = encode(key, path);
+        size_t bytes = entry.bytes();
+        if (bytes > budget) return path;
+
+        std::lock_guard<std::mutex> guard(lock);
+        // Сетка могла измениться, пока шёл поиск, или путь уже добавил другой поток
+        if (version != maze.version() || version != cachedVersion || index.count(key)) {
+            return path;
+        }
+        lru.push_front(std::move(entry));
+        index[key] = lru.begin();
+        usedBytes += bytes;
+        while (usedBytes > budget) {
+            usedBytes -= lru.back().bytes();
+            index.erase(lru.back().key);
+            lru.pop_back();
         }
+        return path;
+    }
+
+public:
+    explicit PathCache(const Maze& maze, size_t budgetBytes = 64 << 20)
+        : maze(maze), budget(budgetBytes), cachedVersion(maze.version()) {}
+
+    std::vector<std::pair<int, int>> findPathWave(std::pair<int, int> start, std::pair<int, int> end) {
+        return lookup(start, end, Algorithm::Wave);
+    }
+
+    std::vector<std::pair<int, int>> findPathBFS(std::pair<int, int> start, std::pair<int, int> end) {
+        return lookup(start, end, Algorithm::BFS);
+    }
+
+    size_t hits() const {
+        return hitCount;
+    }
+
+    size_t misses() const {
+        return missCount;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return lru.size();
+    }
+
+    size_t bytesUsed() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return usedBytes;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> guard(lock);
+        lru.clear();
+        index.clear();
+        usedBytes = 0;
+    }
+
+    void printStats() const {
+        std::cout << "Path cache: " << size() << " paths, " << bytesUsed() << " bytes, "
+                  << hits() << " hits, " << misses() << " misses" << std::endl;
+    }
+};
+
+// Иерархический индекс (HPA*) для многократных запросов к неизменному лабиринту.
+// Сетка делится на кластеры clusterSize x clusterSize; на общих границах соседних
+// кластеров выбираются входы, а внутри кластера заранее считаются расстояния
+// между входами. Запрос ищет путь по маленькому абстрактному графу входов и
+// затем уточняет его волной только внутри выбранных кластеров.
+// Путь получается допустимым, но не обязательно кратчайшим.
+class HierarchicalIndex {
+private:
+    struct Edge {
+        int to;
+        int cost;
+    };
+
+    const Maze& maze;
+    int clusterSize;
+    // Граф индекса построен по версии лабиринта builtVersion. Если лабиринт
+    // с тех пор менялся, первый же запрос перестраивает граф под indexLock
+    // (запросы держат его на чтение), поэтому поля графа mutable.
+    mutable std::shared_mutex indexLock;
+    mutable uint64_t builtVersion = 0;
+    mutable int clustersX = 0, clustersY = 0;
+    mutable std::vector<int> nodeKey;                   // клетка абстрактного узла
+    mutable std::vector<int> nodeCluster;
+    mutable std::vector<std::vector<int>> clusterNodes; // узлы каждого кластера
+    mutable std::vector<std::vector<Edge>> edges;
+    mutable std::unordered_map<int, int> nodeOfKey;
+    mutable double buildTime = 0;
+    // Статистика последнего запроса; запросы могут идти из нескольких потоков
+    mutable std::atomic<size_t> expandedCount{0};
+
+    int clusterOf(int x, int y) const {
+        return (x / clusterSize) * clustersY + (y / clusterSize);
+    }
 
-        visitedCells.clear();
+    int clusterOfKey(int key) const {
+        auto [x, y] = maze.keyToCoord(key);
+        return clusterOf(x, y);
+    }
+
+    int addNode(int key) const {
+        auto it = nodeOfKey.find(key);
+        if (it != nodeOfKey.end()) return it->second;
+        int id = nodeKey.size();
+        nodeKey.push_back(key);
+        nodeCluster.push_back(clusterOfKey(key));
+        clusterNodes[nodeCluster.back()].push_back(id);
+        edges.emplace_back();
+        nodeOfKey[key] = id;
+        return id;
+    }
+
+    // Вход между клетками a и b соседних кластеров (середина общего прохода)
+    void addEntrance(int aKey, int bKey) const {
+        int a = addNode(aKey);
+        int b = addNode(bKey);
+        edges[a].push_back({b, 1});
+        edges[b].push_back({a, 1});
+    }
 
-        std::queue<std::pair<std::pair<int, int>,
-                            std::vector<std::pair<int, int>>>> q;
+    // Волна от fromKey, не выходящая за границы кластера; результат в workspace потока.
+    // Возвращает число раскрытых клеток.
+    size_t clusterWave(int fromKey, int cluster, int targetKey = -1) const {
+        Maze::SearchWorkspace& ws = Maze::threadWorkspace();
+        ws.begin(maze.cellCount());
+        ws.dist.resize(maze.cellCount());
 
+        int x0 = cluster / clustersY * clusterSize, y0 = cluster % clustersY * clusterSize;
+        int x1 = std::min(x0 + clusterSize, maze.rows), y1 = std::min(y0 + clusterSize, maze.cols);
         const int dx[4] = {-1, 0, 1, 0};
         const int dy[4] = {0, 1, 0, -1};
 
-        std::vector<std::pair<int, int>> initialPath = {start};
-        q.push({start, initialPath});
-        visitedCells.insert(coordToKey(start.first, start.second));
+        int head = 0, tail = 0;
+        ws.queue[tail++] = fromKey;
+        ws.stamp[fromKey] = ws.epoch;
+        ws.parent[fromKey] = -1;
+        ws.dist[fromKey] = 0;
+        while (head < tail) {
+            int key = ws.queue[head++];
+            if (key == targetKey) break;
+            auto [x, y] = maze.keyToCoord(key);
+            for (int i = 0; i < 4; i++) {
+                int nx = x + dx[i], ny = y + dy[i];
+                if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1) continue;
+                int nkey = maze.coordToKey(nx, ny);
+                if (!maze.isWall(nkey) && !ws.visited(nkey)) {
+                    ws.stamp[nkey] = ws.epoch;
+                    ws.parent[nkey] = key;
+                    ws.dist[nkey] = ws.dist[key] + 1;
+                    ws.queue[tail++] = nkey;
+                }
+            }
+        }
+        return head;
+    }
+
+    void build() const {
+        auto begin = std::chrono::steady_clock::now();
+        builtVersion = maze.version();
+        nodeKey.clear();
+        nodeCluster.clear();
+        edges.clear();
+        nodeOfKey.clear();
+        int rows = maze.rows, cols = maze.cols;
+        clustersX = (rows + clusterSize - 1) / clusterSize;
+        clustersY = (cols + clusterSize - 1) / clusterSize;
+        clusterNodes.assign(static_cast<size_t>(clustersX) * clustersY, {});
+
+        // Вертикальные границы: столбцы y-1 | y, y кратно clusterSize
+        for (int y = clusterSize; y < cols; y += clusterSize) {
+            for (int x0 = 0; x0 < rows; x0 += clusterSize) {
+                int x1 = std::min(x0 + clusterSize, rows);
+                for (int x = x0; x < x1; ) {
+                    if (!maze.isPassable(x, y - 1) || !maze.isPassable(x, y)) {
+                        x++;
+                        continue;
+                    }
+                    int runStart = x;
+                    while (x < x1 && maze.isPassable(x, y - 1) && maze.isPassable(x, y)) x++;
+                    int mid = (runStart + x - 1) / 2;
+                    addEntrance(maze.coordToKey(mid, y - 1), maze.coordToKey(mid, y));
+                }
+            }
+        }
+        // Горизонтальные границы: строки x-1 / x
+        for (int x = clusterSize; x < rows; x += clusterSize) {
+            for (int y0 = 0; y0 < cols; y0 += clusterSize) {
+                int y1 = std::min(y0 + clusterSize, cols);
+                for (int y = y0; y < y1; ) {
+                    if (!maze.isPassable(x - 1, y) || !maze.isPassable(x, y)) {
+                        y++;
+                        continue;
+                    }
+                    int runStart = y;
+                    while (y < y1 && maze.isPassable(x - 1, y) && maze.isPassable(x, y)) y++;
+                    int mid = (runStart + y - 1) / 2;
+                    addEntrance(maze.coordToKey(x - 1, mid), maze.coordToKey(x, mid));
+                }
+            }
+        }
+
+        // Расстояния между входами одного кластера
+        const Maze::SearchWorkspace& ws = Maze::threadWorkspace();
+        for (size_t c = 0; c < clusterNodes.size(); c++) {
+            const auto& nodes = clusterNodes[c];
+            for (size_t i = 0; i < nodes.size(); i++) {
+                clusterWave(nodeKey[nodes[i]], c);
+                for (size_t j = 0; j < nodes.size(); j++) {
+                    int other = nodeKey[nodes[j]];
+                    if (i != j && ws.visited(other)) {
+                        edges[nodes[i]].push_back({nodes[j], ws.dist[other]});
+                    }
+                }
+            }
+        }
+        expandedCount.store(0, std::memory_order_relaxed);
+        buildTime = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - begin).count();
+    }
 
-        while (!q.empty()) {
-            auto [current, path] = q.front();
-            q.pop();
+    // Путь клеток внутри кластера от fromKey до toKey (обе клетки включительно)
+    void appendClusterPath(int fromKey, int toKey, std::vector<std::pair<int, int>>& path,
+                           size_t& expanded) const {
+        expanded += clusterWave(fromKey, clusterOfKey(fromKey), toKey);
+        std::vector<std::pair<int, int>> part = maze.buildPath(Maze::threadWorkspace(), toKey);
+        path.insert(path.end(), part.begin() + (path.empty() ? 0 : 1), part.end());
+    }
 
-            int x = current.first;
-            int y = current.second;
+    // Доступ к графу на чтение; устаревший граф сначала перестраивается
+    std::shared_lock<std::shared_mutex> currentIndex() const {
+        std::shared_lock<std::shared_mutex> reading(indexLock);
+        while (builtVersion != maze.version()) {
+            reading.unlock();
+            {
+                std::unique_lock<std::shared_mutex> writing(indexLock);
+                if (builtVersion != maze.version()) build();
+            }
+            reading.lock();
+        }
+        return reading;
+    }
 
-            if (x == end.first && y == end.second) {
-                std::cout << "BFS path found! Length: " << path.size() << std::endl;
+    std::vector<std::pair<int, int>> searchPath(std::pair<int, int> start, std::pair<int, int> end,
+                                                size_t& expanded) const {
+        if (maze.knownDisconnected(start, end)) {
+            std::cout << "No hierarchical path found!" << std::endl;
+            return {};
+        }
+
+        const Maze::SearchWorkspace& ws = Maze::threadWorkspace();
+        int startKey = maze.coordToKey(start.first, start.second);
+        int endKey = maze.coordToKey(end.first, end.second);
+        int startCluster = clusterOf(start.first, start.second);
+        int endCluster = clusterOf(end.first, end.second);
+
+        // Обе клетки в одном кластере и связаны внутри него - абстрактный граф не нужен
+        std::vector<std::pair<int, int>> path;
+        if (startCluster == endCluster) {
+            expanded += clusterWave(startKey, startCluster, endKey);
+            if (ws.visited(endKey)) {
+                path = maze.buildPath(ws, endKey);
+                std::cout << "Hierarchical path found! Length: " << path.size() << std::endl;
                 return path;
             }
+        }
 
-            for (int i = 0; i < 4; i++) {
-                int nx = x + dx[i];
-                int ny = y + dy[i];
-                int key = coordToKey(nx, ny);
+        // Временные узлы: S = n, G = n + 1. Рёбра к ним - волной внутри их кластеров.
+        int n = nodeKey.size();
+        int source = n, target = n + 1;
+        std::vector<Edge> startEdges;
+        std::unordered_map<int, int> goalCost;
+        expanded += clusterWave(startKey, startCluster);
+        for (int node : clusterNodes[startCluster]) {
+            if (ws.visited(nodeKey[node])) startEdges.push_back({node, ws.dist[nodeKey[node]]});
+        }
+        expanded += clusterWave(endKey, endCluster);
+        for (int node : clusterNodes[endCluster]) {
+            if (ws.visited(nodeKey[node])) goalCost[node] = ws.dist[nodeKey[node]];
+        }
 
-                if (isPassable(nx, ny) && !visitedCells.contains(key)) {
-                    visitedCells.insert(key);
-                    std::vector<std::pair<int, int>> newPath = path;
-                    newPath.push_back({nx, ny});
-                    q.push({{nx, ny}, newPath});
+        auto heuristic = [&](int node) {
+            int key = node == source ? startKey : node == target ? endKey : nodeKey[node];
+            auto [x, y] = maze.keyToCoord(key);
+            return std::abs(x - end.first) + std::abs(y - end.second);
+        };
+
+        // A* по абстрактному графу
+        std::vector<int> g(n + 2, std::numeric_limits<int>::max());
+        std::vector<int> parent(n + 2, -1);
+        using Entry = std::pair<int, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        g[source] = 0;
+        open.push({heuristic(source), source});
+        while (!open.empty()) {
+            auto [f, u] = open.top();
+            open.pop();
+            if (f - heuristic(u) != g[u]) continue;
+            if (u == target) break;
+            expanded++;
+
+            auto relax = [&](int v, int cost) {
+                if (g[u] + cost < g[v]) {
+                    g[v] = g[u] + cost;
+                    parent[v] = u;
+                    open.push({g[v] + heuristic(v), v});
                 }
+            };
+            const std::vector<Edge>& out = u == source ? startEdges : edges[u];
+            for (const Edge& e : out) relax(e.to, e.cost);
+            if (u < n) {
+                auto it = goalCost.find(u);
+                if (it != goalCost.end()) relax(target, it->second);
             }
         }
 
-        std::cout << "No BFS path found!" << std::endl;
-        return {};
-    }
+        if (parent[target] == -1) {
+            std::cout << "No hierarchical path found!" << std::endl;
+            return {};
+        }
 
-    void printMazeWithPath(const std::vector<std::pair<int, int>>& path = {}) {
-        Avl_Tree pathCells;
-        for (const auto& p : path) {
-            pathCells.insert(coordToKey(p.first, p.second));
+        // Уточнение: соединяем соседние точки абстрактного пути волной внутри кластера
+        std::vector<int> cells;
+        for (int u = target; u != -1; u = parent[u]) {
+            cells.push_back(u == source ? startKey : u == target ? endKey : nodeKey[u]);
         }
+        std::reverse(cells.begin(), cells.end());
 
-        std::cout << "\nMaze (" << rows << "x" << cols << "):\n   ";
-        for (int j = 0; j < cols; j++) {
-            std::cout << j << " ";
+        for (size_t i = 0; i + 1 < cells.size(); i++) {
+            int from = cells[i], to = cells[i + 1];
+            if (from == to) continue;
+            if (clusterOfKey(from) == clusterOfKey(to)) {
+                appendClusterPath(from, to, path, expanded);
+            } else {
+                // Переход через границу кластеров - один шаг
+                if (path.empty()) path.push_back(maze.keyToCoord(from));
+                path.push_back(maze.keyToCoord(to));
+            }
         }
-        std::cout << "\n";
+        if (path.empty()) path.push_back(start);
 
-        for (int i = 0; i < rows; i++) {
-            std::cout << i << "  ";
-            for (int j = 0; j < cols; j++) {
-                int key = coordToKey(i, j);
-                if (!path.empty() && pathCells.contains(key)) {
-                    std::cout << "* ";
-                } else if (grid[i][j] == 1) {
-                    std::cout << "# ";
-                } else {
-                    std::cout << ". ";
+        std::cout << "Hierarchical path found! Length: " << path.size() << std::endl;
+        return path;
+    }
+
+public:
+    HierarchicalIndex(const Maze& m, int size = 16) : maze(m), clusterSize(std::max(size, 2)) {
+        build();
+    }
+
+    // Запросы константны и могут идти из нескольких потоков одновременно
+    std::vector<std::pair<int, int>> findPath(std::pair<int, int> start,
+                                              std::pair<int, int> end) const {
+        auto reading = currentIndex();
+        size_t expanded = 0;
+        std::vector<std::pair<int, int>> path = searchPath(start, end, expanded);
+        expandedCount.store(expanded, std::memory_order_relaxed);
+        return path;
+    }
+
+    // Сколько абстрактных узлов и клеток внутри кластеров раскрыл последний запрос
+    size_t lastExpanded() const {
+        return expandedCount.load(std::memory_order_relaxed);
+    }
+
+    size_t nodeCount() const {
+        auto reading = currentIndex();
+        return nodeKey.size();
+    }
+
+    size_t edgeCount() const {
+        auto reading = currentIndex();
+        size_t count = 0;
+        for (const auto& out : edges) count += out.size();
+        return count;
+    }
+
+    // Приблизительный объём индекса в байтах
+    size_t memoryBytes() const {
+        auto reading = currentIndex();
+        size_t bytes = nodeKey.capacity() * sizeof(int) + nodeCluster.capacity() * sizeof(int);
+        for (const auto& nodes : clusterNodes) bytes += sizeof(nodes) + nodes.capacity() * sizeof(int);
+        for (const auto& out : edges) bytes += sizeof(out) + out.capacity() * sizeof(Edge);
+        bytes += nodeOfKey.size() * (sizeof(std::pair<const int, int>) + 2 * sizeof(void*));
+        return bytes;
+    }
+
+    void printStats() const {
+        size_t nodes = nodeCount(), edgeTotal = edgeCount(), bytes = memoryBytes();
+        auto reading = currentIndex();
+        std::cout << "Clusters: " << clustersX << "x" << clustersY
+                  << " (size " << clusterSize << ")" << std::endl;
+        std::cout << "Abstract nodes: " << nodes << ", edges: " << edgeTotal << std::endl;
+        std::cout << "Index memory: " << bytes << " bytes" << std::endl;
+        std::cout << "Preprocessing time: " << buildTime << " ms" << std::endl;
+    }
+};
+
+// Инкрементальный планировщик (LPA*) для пары (start, goal) на лабиринте.
+// После правок стен через setCell (или уведомления cellChanged) пересчитываются
+// только клетки, на которые правка действительно повлияла, а не вся волна.
+class IncrementalPlanner {
+private:
+    static constexpr int INF = std::numeric_limits<int>::max() / 2;
+    using Entry = std::tuple<int, int, int>; // (k1, k2, key)
+
+    Maze& maze;
+    std::pair<int, int> start, goal;
+    int startKey = -1, goalKey = -1;
+    // Версия лабиринта, по которой посчитаны g и rhs, и число правок после неё,
+    // переданных через setCell/cellChanged. Если версия ушла дальше, значит
+    // лабиринт менялся в обход планировщика (setGrid, loadMapped, генератор) -
+    // тогда поиск начинается заново.
+    uint64_t version = 0;
+    uint64_t reportedEdits = 0;
+    std::vector<int> g;
+    std::vector<int> rhs;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    std::vector<int> pendingCells;
+    size_t expandedCount = 0;
+
+    int heuristic(int key) const {
+        auto [x, y] = maze.keyToCoord(key);
+        return std::abs(x - goal.first) + std::abs(y - goal.second);
+    }
+
+    std::pair<int, int> calculateKey(int key) const {
+        int m = std::min(g[key], rhs[key]);
+        return {m + heuristic(key), m};
+    }
+
+    // Начать заново: при первом запуске и после неучтённых изменений лабиринта
+    void reset() {
+        size_t cells = maze.cellCount();
+        startKey = maze.coordToKey(start.first, start.second);
+        goalKey = maze.coordToKey(goal.first, goal.second);
+        g.assign(cells, INF);
+        rhs.assign(cells, INF);
+        open = {};
+        pendingCells.clear();
+        rhs[startKey] = 0;
+        auto [k1, k2] = calculateKey(startKey);
+        open.push({k1, k2, startKey});
+    }
+
+    void updateVertex(int key) {
+        if (key != startKey) {
+            int best = INF;
+            if (!maze.isWall(key)) {
+                int offsets[4];
+                maze.neighborOffsets(offsets);
+                for (int i = 0; i < 4; i++) {
+                    best = std::min(best, g[key + offsets[i]] + 1);
                 }
             }
-            std::cout << std::endl;
+            rhs[key] = std::min(best, INF);
+        }
+        if (g[key] != rhs[key]) {
+            auto [k1, k2] = calculateKey(key);
+            open.push({k1, k2, key});
         }
     }
 
-    void printMaze() {
-        std::cout << "\nMaze (" << rows << "x" << cols << "):\n   ";
-        for (int j = 0; j < cols; j++) {
-            std::cout << j << " ";
+    void computeShortestPath() {
+        int offsets[4];
+        maze.neighborOffsets(offsets);
+
+        while (!open.empty()) {
+            auto [k1, k2, key] = open.top();
+            std::pair<int, int> goalKeyPair = calculateKey(goalKey);
+            if (std::make_pair(k1, k2) >= goalKeyPair && rhs[goalKey] == g[goalKey]) break;
+            open.pop();
+
+            // Записи в куче не удаляются, поэтому пропускаем согласованные и устаревшие
+            if (g[key] == rhs[key]) continue;
+            std::pair<int, int> current = calculateKey(key);
+            if (std::make_pair(k1, k2) < current) {
+                open.push({current.first, current.second, key});
+                continue;
+            }
+            expandedCount++;
+
+            if (g[key] > rhs[key]) {
+                g[key] = rhs[key];
+            } else {
+                g[key] = INF;
+                updateVertex(key);
+            }
+            for (int i = 0; i < 4; i++) {
+                int nkey = key + offsets[i];
+                if (!maze.isWall(nkey) || g[nkey] != INF) {
+                    updateVertex(nkey);
+                }
+            }
         }
-        std::cout << "\n";
+    }
 
-        for (int i = 0; i < rows; i++) {
-            std::cout << i << "  ";
-            for (int j = 0; j < cols; j++) {
-                if (grid[i][j] == 1) {
-                    std::cout << "# ";
-                } else {
-                    std::cout << ". ";
+public:
+    IncrementalPlanner(Maze& m, std::pair<int, int> s, std::pair<int, int> e)
+        : maze(m), start(s), goal(e) {}
+
+    // Изменить клетку лабиринта и запомнить её для следующего findPath
+    void setCell(int x, int y, int value) {
+        uint64_t before = maze.version();
+        maze.setCell(x, y, value);
+        if (maze.version() != before) {
+            cellChanged(x, y);
+        }
+    }
+
+    // Клетка изменена напрямую через Maze::setCell. Сообщать нужно о каждой
+    // такой правке: любое неучтённое изменение сбросит планировщик.
+    void cellChanged(int x, int y) {
+        if (maze.isValid(x, y)) {
+            pendingCells.push_back(maze.coordToKey(x, y));
+            reportedEdits++;
+        }
+    }
+
+    // Кратчайший путь start -> goal; длина всегда совпадает с findPathWave
+    std::vector<std::pair<int, int>> findPath() {
+        expandedCount = 0;
+        if (!maze.isValid(start.first, start.second) || !maze.isValid(goal.first, goal.second)) {
+            return {};
+        }
+        if (startKey == -1 || maze.version() != version + reportedEdits) {
+            reset();
+        }
+        version = maze.version();
+        reportedEdits = 0;
+
+        // Правка меняет входящие рёбра самой клетки и её соседей
+        int offsets[4];
+        maze.neighborOffsets(offsets);
+        for (int key : pendingCells) {
+            updateVertex(key);
+            for (int i = 0; i < 4; i++) {
+                updateVertex(key + offsets[i]);
+            }
+        }
+        pendingCells.clear();
+
+        if (maze.isWall(startKey) || maze.isWall(goalKey)) {
+            std::cout << "Start or end position is blocked!" << std::endl;
+            return {};
+        }
+
+        computeShortestPath();
+
+        if (g[goalKey] >= INF) {
+            std::cout << "No incremental path found!" << std::endl;
+            return {};
+        }
+
+        // Спускаемся от цели к старту по соседям с меньшим g
+        std::vector<std::pair<int, int>> path;
+        for (int key = goalKey; ; ) {
+            path.push_back(maze.keyToCoord(key));
+            if (key == startKey) break;
+            int next = -1;
+            for (int i = 0; i < 4; i++) {
+                int nkey = key + offsets[i];
+                if (!maze.isWall(nkey) && (next == -1 || g[nkey] < g[next])) {
+                    next = nkey;
                 }
             }
-            std::cout << std::endl;
+            key = next;
         }
+        std::reverse(path.begin(), path.end());
+
+        std::cout << "Incremental path found! Length: " << path.size() << std::endl;
+        return path;
     }
 
-    void printStats() const {
-        std::cout << "Maze size: " << rows << "x" << cols << std::endl;
-        std::cout << "Visited cells: " << visitedCells.size() << std::endl;
-        std::cout << "Total cells: " << rows * cols << std::endl;
+    // Сколько клеток пересчитал последний findPath
+    size_t lastExpanded() const {
+        return expandedCount;
+    }
+};
 
-        // Подсчет тупиков
-        int deadEnds = 0;
-        for (int i = 0; i < rows; i++) {
-            for (int j = 0; j < cols; j++) {
-                if (isDeadEnd(i, j)) {
-                    deadEnds++;
+// Генераторы идеальных лабиринтов (без циклов) прямо в Maze.
+// Клетки лабиринта лежат на чётных координатах сетки, стены между ними - на
+// нечётных, поэтому лабиринт cellRows x cellCols занимает сетку
+// (2*cellRows - 1) x (2*cellCols - 1). Каждый вызов заново засевает генератор
+// случайных чисел из seed, так что одинаковый seed дает одинаковый лабиринт.
+class MazeGenerator {
+private:
+    uint64_t seed;
+    std::mt19937_64 rng;
+
+    uint64_t coinBits = 0;
+    int coinsLeft = 0;
+
+    void reseed() {
+        rng.seed(seed);
+        coinsLeft = 0;
+    }
+
+    // Случайное число в [0, n): умножение со сдвигом вместо деления
+    uint32_t randomBelow(uint32_t n) {
+        return static_cast<uint32_t>(((rng() >> 32) * n) >> 32);
+    }
+
+    // Монетка: одно число генератора дает 64 броска
+    bool coin() {
+        if (coinsLeft == 0) {
+            coinBits = rng();
+            coinsLeft = 64;
+        }
+        coinsLeft--;
+        bool bit = coinBits & 1;
+        coinBits >>= 1;
+        return bit;
+    }
+
+    // Вся сетка - стены, открыты только клетки лабиринта
+    void prepare(Maze& maze, int cellRows, int cellCols) {
+        maze.allocate(2 * cellRows - 1, 2 * cellCols - 1);
+        std::fill_n(maze.wallBits, maze.wordCount(), ~uint64_t(0));
+        for (int i = 0; i < cellRows; i++) {
+            for (int j = 0; j < cellCols; j++) {
+                maze.setWall(maze.coordToKey(2 * i, 2 * j), false);
+            }
+        }
+    }
+
+    // Убрать стену между соседними клетками a и b (номера i * cellCols + j)
+    void carve(Maze& maze, int cellCols, int a, int b) {
+        int x = (a / cellCols) + (b / cellCols);
+        int y = (a % cellCols) + (b % cellCols);
+        maze.setWall(maze.coordToKey(x, y), false);
+    }
+
+    // Соседние клетки (до четырёх); возвращает их количество
+    static int cellNeighbors(int cell, int cellRows, int cellCols, int out[4]) {
+        int i = cell / cellCols, j = cell % cellCols;
+        int n = 0;
+        if (i > 0) out[n++] = cell - cellCols;
+        if (j + 1 < cellCols) out[n++] = cell + 1;
+        if (i + 1 < cellRows) out[n++] = cell + cellCols;
+        if (j > 0) out[n++] = cell - 1;
+        return n;
+    }
+
+    static bool validSize(int cellRows, int cellCols) {
+        return cellRows > 0 && cellCols > 0;
+    }
+
+public:
+    explicit MazeGenerator(uint64_t seed = 42) : seed(seed), rng(seed) {}
+
+    // Рекурсивный возврат (DFS с явным стеком): длинные извилистые коридоры
+    void recursiveBacktracker(Maze& maze, int cellRows, int cellCols) {
+        if (!validSize(cellRows, cellCols)) return;
+        reseed();
+        prepare(maze, cellRows, cellCols);
+
+        std::vector<uint8_t> visited(static_cast<size_t>(cellRows) * cellCols, 0);
+        std::vector<int> stack;
+        stack.push_back(0);
+        visited[0] = 1;
+        while (!stack.empty()) {
+            int cell = stack.back();
+            int neighbors[4];
+            int n = cellNeighbors(cell, cellRows, cellCols, neighbors);
+            int candidates[4];
+            int count = 0;
+            for (int k = 0; k < n; k++) {
+                if (!visited[neighbors[k]]) candidates[count++] = neighbors[k];
+            }
+            if (count == 0) {
+                stack.pop_back();
+                continue;
+            }
+            int next = candidates[randomBelow(count)];
+            carve(maze, cellCols, cell, next);
+            visited[next] = 1;
+            stack.push_back(next);
+        }
+        maze.gridChanged();
+    }
+
+    // Алгоритм Краскала: случайный порядок стен и система непересекающихся множеств
+    void kruskal(Maze& maze, int cellRows, int cellCols) {
+        if (!validSize(cellRows, cellCols)) return;
+        reseed();
+        prepare(maze, cellRows, cellCols);
+
+        // Стена кодируется как 2 * клетка + направление (0 - вправо, 1 - вниз)
+        std::vector<uint32_t> edges;
+        edges.reserve(2 * static_cast<size_t>(cellRows) * cellCols);
+        for (int i = 0; i < cellRows; i++) {
+            for (int j = 0; j < cellCols; j++) {
+                uint32_t cell = i * cellCols + j;
+                if (j + 1 < cellCols) edges.push_back(2 * cell);
+                if (i + 1 < cellRows) edges.push_back(2 * cell + 1);
+            }
+        }
+        // Тасование Фишера-Йетса на своём генераторе, чтобы порядок не зависел от библиотеки
+        for (size_t k = edges.size(); k > 1; k--) {
+            std::swap(edges[k - 1], edges[randomBelow(k)]);
+        }
+
+        // Объединение по рангу держит деревья множеств низкими
+        std::vector<uint32_t> parent(static_cast<size_t>(cellRows) * cellCols);
+        std::vector<uint8_t> rank(parent.size(), 0);
+        for (size_t k = 0; k < parent.size(); k++) parent[k] = k;
+        auto find = [&](uint32_t v) {
+            while (parent[v] != v) {
+                parent[v] = parent[parent[v]];
+                v = parent[v];
+            }
+            return v;
+        };
+
+        for (uint32_t edge : edges) {
+            int a = edge / 2;
+            int b = (edge & 1) ? a + cellCols : a + 1;
+            uint32_t ra = find(a), rb = find(b);
+            if (ra == rb) continue;
+            if (rank[ra] < rank[rb]) std::swap(ra, rb);
+            parent[rb] = ra;
+            if (rank[ra] == rank[rb]) rank[ra]++;
+            carve(maze, cellCols, a, b);
+        }
+        maze.gridChanged();
+    }
+
+    // Алгоритм Уилсона: случайные блуждания со стиранием петель.
+    // Дает равномерно распределённое остовное дерево, но медленнее остальных
+    void wilson(Maze& maze, int cellRows, int cellCols) {
+        if (!validSize(cellRows, cellCols)) return;
+        reseed();
+        prepare(maze, cellRows, cellCols);
+
+        size_t total = static_cast<size_t>(cellRows) * cellCols;
+        std::vector<uint8_t> inTree(total, 0);
+        std::vector<int> next(total, -1); // последний шаг блуждания из клетки
+        inTree[randomBelow(total)] = 1;
+
+        for (size_t startCell = 0; startCell < total; startCell++) {
+            if (inTree[startCell]) continue;
+
+            // Блуждаем до дерева, запоминая только последний выход из клетки -
+            // так петли стираются сами собой
+            int cell = startCell;
+            while (!inTree[cell]) {
+                int neighbors[4];
+                int n = cellNeighbors(cell, cellRows, cellCols, neighbors);
+                next[cell] = neighbors[randomBelow(n)];
+                cell = next[cell];
+            }
+
+            // Присоединяем путь без петель к дереву
+            for (cell = startCell; !inTree[cell]; cell = next[cell]) {
+                inTree[cell] = 1;
+                carve(maze, cellCols, cell, next[cell]);
+            }
+        }
+        maze.gridChanged();
+    }
+
+    // Алгоритм Эллера: лабиринт строится построчно, в памяти только одна строка
+    // множеств. Каждая готовая строка сетки (2 * cellCols - 1 значений, 1 - стена)
+    // передается в sink, поэтому лабиринт можно писать на диск, не держа целиком
+    void ellerRows(int cellRows, int cellCols,
+                   const std::function<void(const std::vector<int>&)>& sink) {
+        if (!validSize(cellRows, cellCols)) return;
+        reseed();
+
+        int width = 2 * cellCols - 1;
+        std::vector<int> label(cellCols, -1); // множество клетки в текущей строке
+        std::vector<int> parent(cellCols);    // объединения множеств внутри строки
+        std::vector<int> remap(cellCols);
+        std::vector<int> lastColumn(cellCols);
+        std::vector<uint8_t> hasDown(cellCols);
+        std::vector<int> cellRow(width), wallRow(width);
+        auto find = [&](int v) {
+            while (parent[v] != v) {
+                parent[v] = parent[parent[v]];
+                v = parent[v];
+            }
+            return v;
+        };
+
+        for (int i = 0; i < cellRows; i++) {
+            bool lastRow = i + 1 == cellRows;
+
+            // Сжимаем метки в 0..k-1 и выдаем новые клеткам без множества
+            std::fill(remap.begin(), remap.end(), -1);
+            int labels = 0;
+            for (int j = 0; j < cellCols; j++) {
+                if (label[j] >= 0) {
+                    if (remap[label[j]] < 0) remap[label[j]] = labels++;
+                    label[j] = remap[label[j]];
+                }
+            }
+            for (int j = 0; j < cellCols; j++) {
+                if (label[j] < 0) label[j] = labels++;
+            }
+            for (int k = 0; k < labels; k++) parent[k] = k;
+
+            // Горизонтальные проходы: соединяем соседей из разных множеств
+            std::fill(cellRow.begin(), cellRow.end(), 1);
+            cellRow[0] = 0;
+            for (int j = 0; j + 1 < cellCols; j++) {
+                cellRow[2 * j + 2] = 0;
+                int a = find(label[j]), b = find(label[j + 1]);
+                if (a != b && (lastRow || coin())) {
+                    parent[a] = b;
+                    cellRow[2 * j + 1] = 0;
+                }
+            }
+            sink(cellRow);
+            if (lastRow) break;
+
+            // Вертикальные проходы: у каждого множества хотя бы один вниз
+            for (int j = 0; j < cellCols; j++) {
+                label[j] = find(label[j]);
+                lastColumn[label[j]] = j;
+                hasDown[label[j]] = 0;
+            }
+            std::fill(wallRow.begin(), wallRow.end(), 1);
+            for (int j = 0; j < cellCols; j++) {
+                int set = label[j];
+                bool down = coin() || (lastColumn[set] == j && !hasDown[set]);
+                if (down) {
+                    hasDown[set] = 1;
+                    wallRow[2 * j] = 0;
+                } else {
+                    label[j] = -1;
                 }
             }
+            sink(wallRow);
         }
-        std::cout << "Dead ends: " << deadEnds << std::endl;
     }
 
-    void clear() {
-        grid.clear();
-        visitedCells.clear();
-        rows = cols = 0;
+    // Эллер с записью строк прямо в лабиринт
+    void eller(Maze& maze, int cellRows, int cellCols) {
+        if (!validSize(cellRows, cellCols)) return;
+        maze.allocate(2 * cellRows - 1, 2 * cellCols - 1);
+        int x = 0;
+        ellerRows(cellRows, cellCols, [&](const std::vector<int>& row) {
+            int key = maze.coordToKey(x, 0);
+            for (int y = 0; y < static_cast<int>(row.size()); y++) {
+                maze.setWall(key + y, row[y] != 0);
+            }
+            x++;
+        });
+        maze.gridChanged();
     }
 };
 
 // Демонстрация работы
+// Бенчмарки и тесты подключают этот файл с NO_DEMO_MAIN, чтобы получить классы без демо
+#ifndef NO_DEMO_MAIN
 int main() {
     // Создаем лабиринт с тупиками
     std::vector<std::vector<int>> mazeGrid = {
@@ -653,7 +4092,9 @@ int main() {
     maze.printMazeWithPath(pathBefore);
 
     // Применяем Braiding Algorithm
-    maze.braidMaze(0.7); // Braid 70% тупиков
+    // Каждый тупик зашивается с вероятностью 0.7; из трёх тупиков этого
+    // лабиринта при seed по умолчанию выпадает один
+    maze.braidMaze(0.7);
 
     // Показываем лабиринт после брайдинга
     std::cout << "\n--- MAZE AFTER BRAIDING ---" << std::endl;
@@ -675,3 +4116,4 @@ int main() {
 
     return 0;
 }
+#endif
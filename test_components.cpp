@@ -0,0 +1,78 @@
+// Тест индекса компонент при правках по одной клетке (setCell):
+//  1) разрез, не уложившийся в бюджет волны, сбрасывает индекс, и первый же
+//     поиск между половинами перестраивает его и выходит без раскрытия клеток;
+//  2) после случайных правок число компонент совпадает с индексом,
+//     построенным заново на копии лабиринта.
+//
+//   g++ -std=c++23 -O2 -pthread test_components.cpp -o test_components && ./test_components
+#define NO_DEMO_MAIN
+#include "project.cpp"
+
+#include <sstream>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        failures++;
+        std::cerr << "FAIL " << what << std::endl;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::ostringstream sink;
+    auto* saved = std::cout.rdbuf(sink.rdbuf());
+
+    // 1) Стена посередине с одним проёмом; обе половины больше бюджета разреза
+    const int n = 300;
+    Maze maze(n, n);
+    for (int x = 0; x < n; x++) {
+        if (x != n / 2) maze.setCell(x, n / 2, 1);
+    }
+    std::pair<int, int> left = {0, 0}, right = {n - 1, n - 1};
+    check(maze.componentCount() == 1, "one component while the gap is open");
+    maze.setCell(n / 2, n / 2, 1);
+
+    auto wave = maze.findPathWave(left, right);
+    check(wave.empty(), "no path across the closed wall");
+    check(maze.lastExpanded() == 0, "disconnected query after an over-budget split expands no cells");
+    auto bfs = maze.findPathBFS(right, left);
+    check(bfs.empty() && maze.lastExpanded() == 0, "the rebuilt index serves later searches");
+    check(maze.componentCount() == 2, "two components after the split");
+
+    // Снова открыть проём: слияние идёт по индексу без перестройки
+    maze.setCell(n / 2, n / 2, 0);
+    check(!maze.findPathWave(left, right).empty(), "path after reopening the gap");
+    check(maze.componentCount() == 1, "one component after reopening the gap");
+
+    // 2) Случайные правки против индекса, построенного с нуля
+    const int size = 96;
+    std::mt19937_64 rng(10);
+    Maze edited(size, size);
+    for (int x = 0; x < size; x++) {
+        for (int y = 0; y < size; y++) {
+            if (rng() % 3 == 0) edited.setCell(x, y, 1);
+        }
+    }
+    edited.componentCount();
+    for (int step = 0; step < 2000; step++) {
+        edited.setCell(rng() % size, rng() % size, rng() % 2);
+        if (step % 50 == 0) {
+            Maze fresh(edited);
+            check(edited.componentCount() == fresh.componentCount(),
+                  "incremental count matches a rebuild at step " + std::to_string(step));
+        }
+    }
+
+    std::cout.rdbuf(saved);
+    if (failures) {
+        std::cout << failures << " component index checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Component index checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Тест findPathJPS: на случайных лабиринтах длина пути JPS должна совпадать
+// с findPathWave, а сам путь - быть связной цепочкой проходов от старта до финиша.
+// Ширины выбраны так, чтобы прыжки пересекали границы 64-битных слов.
+//
+//   g++ -std=c++23 -O2 -pthread test_jps.cpp -o test_jps && ./test_jps
+#define NO_DEMO_MAIN
+#include "project.cpp"
+
+#include <sstream>
+
+namespace {
+
+int failures = 0;
+
+void fail(const std::string& what, int rows, int cols, uint64_t seed,
+          std::pair<int, int> start, std::pair<int, int> end) {
+    if (++failures <= 10) {
+        std::cerr << "FAIL " << what << ": " << rows << "x" << cols << " seed " << seed
+                  << " (" << start.first << "," << start.second << ") -> ("
+                  << end.first << "," << end.second << ")" << std::endl;
+    }
+}
+
+bool validPath(const Maze& maze, const std::vector<std::pair<int, int>>& path,
+               std::pair<int, int> start, std::pair<int, int> end) {
+    if (path.front() != start || path.back() != end) return false;
+    for (size_t i = 0; i < path.size(); i++) {
+        if (maze.cellCost(path[i].first, path[i].second) == 0) return false;
+        if (i > 0 && std::abs(path[i].first - path[i - 1].first) +
+                     std::abs(path[i].second - path[i - 1].second) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Сравнить JPS и волну на queries случайных парах проходов
+void checkMaze(const Maze& maze, int rows, int cols, uint64_t seed, int queries) {
+    std::mt19937_64 rng(seed);
+    auto randomOpenCell = [&]() {
+        for (int attempt = 0; attempt < 1000; attempt++) {
+            std::pair<int, int> cell = {static_cast<int>(rng() % rows), static_cast<int>(rng() % cols)};
+            if (maze.cellCost(cell.first, cell.second) != 0) return cell;
+        }
+        return std::pair<int, int>{-1, -1};
+    };
+
+    for (int q = 0; q < queries; q++) {
+        auto start = randomOpenCell();
+        auto end = randomOpenCell();
+        if (start.first < 0 || end.first < 0) return;
+
+        auto wave = maze.findPathWave(start, end);
+        auto jps = maze.findPathJPS(start, end);
+        if (wave.size() != jps.size()) {
+            fail("length " + std::to_string(jps.size()) + " != wave " + std::to_string(wave.size()),
+                 rows, cols, seed, start, end);
+        } else if (!jps.empty() && !validPath(maze, jps, start, end)) {
+            fail("broken path", rows, cols, seed, start, end);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    // Поиски печатают результат каждого запроса - оставляем только отчёт теста
+    std::ostringstream sink;
+    auto* saved = std::cout.rdbuf(sink.rdbuf());
+
+    const int widths[] = {1, 2, 7, 63, 64, 65, 127, 130, 200};
+    const double wallShares[] = {0.0, 0.1, 0.25, 0.4};
+    size_t mazes = 0;
+
+    for (int cols : widths) {
+        for (int rows : {1, 9, 40}) {
+            for (double share : wallShares) {
+                for (uint64_t seed = 1; seed <= 3; seed++) {
+                    std::mt19937_64 rng(seed * 7919 + rows * 31 + cols);
+                    std::bernoulli_distribution wall(share);
+                    std::vector<std::vector<int>> grid(rows, std::vector<int>(cols, 0));
+                    for (auto& row : grid) {
+                        for (int& cell : row) cell = wall(rng) ? 1 : 0;
+                    }
+                    Maze maze(grid);
+                    checkMaze(maze, rows, cols, seed, 30);
+                    mazes++;
+                    sink.str("");
+                }
+            }
+        }
+    }
+
+    // Идеальные лабиринты генераторов: длинные коридоры и много вынужденных поворотов
+    for (uint64_t seed = 1; seed <= 5; seed++) {
+        MazeGenerator generator(seed);
+        Maze maze;
+        generator.recursiveBacktracker(maze, 20, 50);
+        checkMaze(maze, 39, 99, seed, 50);
+        generator.kruskal(maze, 33, 40);
+        checkMaze(maze, 65, 79, seed, 50);
+        maze.braidMaze(0.5, seed, false);
+        checkMaze(maze, 65, 79, seed, 50);
+        mazes += 3;
+        sink.str("");
+    }
+
+    std::cout.rdbuf(saved);
+    if (failures) {
+        std::cout << failures << " JPS checks failed on " << mazes << " mazes" << std::endl;
+        return 1;
+    }
+    std::cout << "JPS matches wave on " << mazes << " mazes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Тест файлов лабиринта: save -> loadMapped сохраняет стены и стоимости, а save
+// в тот же файл, из которого лабиринт отображён, не портит ни файл, ни сам
+// лабиринт (раньше файл усекался под живым отображением и поиск падал с SIGBUS).
+//
+//   g++ -std=c++23 -O2 -pthread test_maze_file.cpp -o test_maze_file && ./test_maze_file
+#define NO_DEMO_MAIN
+#include "project.cpp"
+
+#include <filesystem>
+#include <sstream>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        failures++;
+        std::cerr << "FAIL " << what << std::endl;
+    }
+}
+
+bool sameCells(const Maze& a, const Maze& b, int rows, int cols) {
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < cols; y++) {
+            if (a.cellCost(x, y) != b.cellCost(x, y)) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::ostringstream sink;
+    auto* saved = std::cout.rdbuf(sink.rdbuf());
+
+    const int rows = 100, cols = 130;
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("test_maze_file_" + std::to_string(getpid()) + ".bin")).string();
+
+    std::mt19937_64 rng(16);
+    std::vector<std::vector<int>> grid(rows, std::vector<int>(cols));
+    for (auto& row : grid) {
+        for (int& cell : row) cell = rng() % 5 == 0 ? 0 : 1 + rng() % 9;
+    }
+    grid[0][0] = grid[rows - 1][cols - 1] = 1;
+    Maze original;
+    original.setCostGrid(grid);
+
+    check(original.save(path), "save");
+    Maze mapped;
+    check(mapped.loadMapped(path), "loadMapped");
+    check(sameCells(original, mapped, rows, cols), "walls and costs survive save/loadMapped");
+
+    // Правим отображённый лабиринт и сохраняем его в тот же файл
+    for (int i = 0; i < 200; i++) {
+        mapped.setCell(1 + rng() % (rows - 2), 1 + rng() % (cols - 2), rng() % 2);
+    }
+    Maze expected(mapped);
+    check(mapped.save(path), "save over the mapped source");
+    // Заголовок 40 байт, биты стен и байт стоимости на каждую клетку с рамкой
+    size_t cells = size_t(rows + 2) * ((cols + 2 + 63) / 64 * 64);
+    check(std::filesystem::file_size(path) == 40 + cells / 8 + cells,
+          "file size after saving over the mapped source");
+    check(!std::filesystem::exists(path + ".tmp"), "no temporary file left behind");
+
+    // Отображение должно остаться целым: поиск читает все слова сетки
+    auto path1 = mapped.findPathBFS({0, 0}, {rows - 1, cols - 1});
+    auto path2 = expected.findPathBFS({0, 0}, {rows - 1, cols - 1});
+    check(path1 == path2, "search on the mapped maze after save");
+    check(sameCells(expected, mapped, rows, cols), "mapped maze unchanged by save");
+
+    Maze reloaded;
+    check(reloaded.loadMapped(path), "loadMapped of the rewritten file");
+    check(sameCells(expected, reloaded, rows, cols), "rewritten file holds the edited maze");
+
+    std::filesystem::remove(path);
+    std::cout.rdbuf(saved);
+    if (failures) {
+        std::cout << failures << " maze file checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Maze file checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Тест AVL-деревьев: Avl_Tree и CompactAvlTree против std::set на случайных
+// последовательностях вставок, удалений и поисков. Сверяются результаты
+// каждой операции и размер, а после серии - принадлежность всех ключей.
+// Узкий диапазон ключей даёт много повторных вставок и удалений найденного.
+//
+//   g++ -std=c++23 -O2 -pthread test_trees.cpp -o test_trees && ./test_trees
+#define NO_DEMO_MAIN
+#include "project.cpp"
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        failures++;
+        std::cerr << "FAIL " << what << std::endl;
+    }
+}
+
+template <typename Tree>
+void crossCheck(const std::string& name, int keyRange, int operations, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Tree tree;
+    std::set<int> expected;
+    std::string where = name + " (keys " + std::to_string(keyRange) + ", seed " + std::to_string(seed) + ")";
+    for (int i = 0; i < operations; i++) {
+        int key = static_cast<int>(rng() % keyRange) - keyRange / 2;
+        bool ok = true;
+        switch (rng() % 3) {
+        case 0:
+            ok = tree.insert(key) == expected.insert(key).second;
+            break;
+        case 1:
+            ok = tree.remove(key) == (expected.erase(key) == 1);
+            break;
+        default:
+            ok = tree.contains(key) == expected.contains(key);
+            break;
+        }
+        if (!ok || tree.size() != expected.size()) {
+            check(false, where + " operation " + std::to_string(i) + " on key " + std::to_string(key));
+            return;
+        }
+    }
+    for (int key = -keyRange / 2 - 1; key <= keyRange / 2 + 1; key++) {
+        if (tree.contains(key) != expected.contains(key)) {
+            check(false, where + " final membership of key " + std::to_string(key));
+            return;
+        }
+    }
+    // После удаления всех ключей дерево пустое и снова принимает вставки
+    for (int key : expected) tree.remove(key);
+    check(tree.empty() && tree.insert(7) && tree.contains(7) && tree.size() == 1,
+          where + " reuse after removing every key");
+}
+
+} // namespace
+
+int main() {
+    for (uint64_t seed = 1; seed <= 5; seed++) {
+        for (int keyRange : {16, 1000, 100000}) {
+            crossCheck<Avl_Tree>("Avl_Tree", keyRange, 50000, seed);
+            crossCheck<CompactAvlTree>("CompactAvlTree", keyRange, 50000, seed);
+        }
+    }
+
+    if (failures) {
+        std::cout << failures << " tree checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Tree checks passed" << std::endl;
+    return 0;
+}